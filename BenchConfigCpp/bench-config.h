@@ -15,6 +15,15 @@
 #include <ranges>
 #include <functional>
 #include <concepts>
+#include <fstream>
+#include <set>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
 
 #define FMT_STATIC
 #define FMT_UNICODE 0
@@ -170,12 +179,6 @@ namespace benchcfg
 {
 	struct BenchConfig
 	{
-		//struct Arg
-		//{
-		//	std::string name;
-		//	int64_t value;
-		//};
-
 		struct ValueRange
 		{
 			int64_t start;
@@ -183,6 +186,24 @@ namespace benchcfg
 			std::optional<int> step = std::nullopt;
 		};
 
+		// Buffer sizes clustered around every data cache size of the host, from size / spread to size * spread,
+		// followed by one size in DRAM
+		struct CacheSweep
+		{
+			std::optional<int> points_per_level = std::nullopt;
+			std::optional<double> spread = std::nullopt;
+			std::optional<int64_t> dram_size = std::nullopt;
+		};
+
+		// One dimension of the argument product, the listed values followed by the values of the range and the cache sweep
+		struct Arg
+		{
+			std::string name;
+			std::optional<std::vector<int64_t>> values = std::nullopt;
+			std::optional<ValueRange> range = std::nullopt;
+			std::optional<CacheSweep> cache_sweep = std::nullopt;
+		};
+
 		struct ThreadRange
 		{
 			int min_threads;
@@ -190,17 +211,12 @@ namespace benchcfg
 			std::optional<int> stride = std::nullopt;
 		};
 
-		//BENCHCFG_FIELD(
-		//	args,
-		//	"Benchmark function args",
-		//	std::optional<std::vector<Arg>>,
-		//	std::nullopt)
-
-		//BENCHCFG_FIELD(
-		//	args,
-		//	"Benchmark function args",
-		//	std::optional<std::vector<int64_t>>,
-		//	std::nullopt)
+		struct LengthDistribution
+		{
+			int64_t min;
+			std::optional<int64_t> max = std::nullopt;
+			std::optional<double> mean = std::nullopt;
+		};
 
 		BENCHCFG_FIELD(
 			name,
@@ -223,8 +239,8 @@ namespace benchcfg
 		BENCHCFG_FIELD(
 			value_range,
 			"Start and end values for benchmark range",
-			ValueRange,
-			ValueRange{})
+			std::optional<ValueRange>,
+			std::nullopt)
 		
 		BENCHCFG_FIELD(
 			value_range_list,
@@ -232,6 +248,18 @@ namespace benchcfg
 			BENCHCFG_WRAP(std::optional<std::vector<std::pair<int64_t, int64_t>>>),
 			std::nullopt)
 
+		BENCHCFG_FIELD(
+			cache_sweep,
+			"Buffer sizes around the cache sizes of the host, takes precedence over the value ranges",
+			std::optional<CacheSweep>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			args,
+			"Named benchmark arguments, every combination of their values is run. Takes precedence over the value ranges",
+			std::optional<std::vector<Arg>>,
+			std::nullopt)
+
 		BENCHCFG_FIELD(
 			range_multiplier,
 			"Multiplier for range values",
@@ -291,7 +319,225 @@ namespace benchcfg
 			"Range of concurrent threads",
 			std::optional<ThreadRange>,
 			std::nullopt)
+
+		BENCHCFG_FIELD(
+			use_real_time,
+			"Measure wall-clock instead of CPU time, needed for multi-threaded throughput",
+			std::optional<bool>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			pool_size,
+			"Number of generated inputs a benchmark cycles through",
+			std::optional<int64_t>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			length_distribution,
+			"Lengths of the generated inputs: geometric with the given mean, uniform without one",
+			std::optional<LengthDistribution>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			match_rate,
+			"Fraction of the generated inputs holding a match",
+			std::optional<double>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			match_offsets,
+			"Offsets of a single match, negative ones count from the end and null places none",
+			std::optional<std::vector<std::optional<int64_t>>>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			corpus_files,
+			"Files memory-mapped read-only and searched as they are, relative to the working directory",
+			std::optional<std::vector<std::string>>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			page_size,
+			"Page size of the generated buffers in bytes, 4096 or 2097152 for huge pages",
+			std::optional<int64_t>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			dataset_cache_size,
+			"Bytes of generated buffers kept in memory and shared by the next benchmarks",
+			std::optional<int64_t>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			dataset_seed,
+			"Seed of the generated buffers",
+			std::optional<uint64_t>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			dataset_dir,
+			"Directory where generated buffers are stored and memory-mapped from by later runs, relative to the working directory",
+			std::optional<std::string>,
+			std::nullopt)
+
+		BENCHCFG_FIELD(
+			perf_counters,
+			"Hardware events counted around the timed loop of the line benchmarks with perf_event_open, Linux only",
+			std::optional<std::vector<std::string>>,
+			std::nullopt)
+	};
+}
+
+// Cache topology
+namespace benchcfg
+{
+	struct CacheLevel
+	{
+		int level;
+		int64_t size;
 	};
+
+	// Data and unified caches of cpu0 from sysfs, e.g. "48K"
+	inline std::vector<CacheLevel> readSysfsCacheLevels()
+	{
+		std::vector<CacheLevel> levels;
+
+		for (int index = 0; ; index++)
+		{
+			const fs::path dir = fs::path("/sys/devices/system/cpu/cpu0/cache") / ("index" + std::to_string(index));
+
+			std::ifstream level_file(dir / "level");
+			std::ifstream type_file(dir / "type");
+			std::ifstream size_file(dir / "size");
+
+			if (!level_file || !type_file || !size_file)
+				break;
+
+			int level = 0;
+			std::string type;
+			std::string size;
+			level_file >> level;
+			type_file >> type;
+			size_file >> size;
+
+			if (type == "Instruction" || size.empty())
+				continue;
+
+			int64_t bytes = std::strtoll(size.c_str(), nullptr, 10);
+
+			switch (size.back())
+			{
+			case 'K': bytes <<= 10; break;
+			case 'M': bytes <<= 20; break;
+			case 'G': bytes <<= 30; break;
+			}
+
+			levels.push_back({ level, bytes });
+		}
+
+		return levels;
+	}
+
+	// Deterministic cache parameters: CPUID leaf 4 on Intel, 0x8000001D on AMD, which share the layout
+	inline std::vector<CacheLevel> readCpuidCacheLevels()
+	{
+		std::vector<CacheLevel> levels;
+
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		auto cpuid = [](unsigned int leaf, unsigned int subleaf, unsigned int regs[4])
+		{
+#if defined(_MSC_VER)
+			__cpuidex((int*)regs, (int)leaf, (int)subleaf);
+#else
+			__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		};
+
+		unsigned int regs[4];
+		cpuid(0, 0, regs);
+		const unsigned int max_leaf = regs[0];
+		cpuid(0x80000000, 0, regs);
+		const unsigned int max_extended_leaf = regs[0];
+
+		for (unsigned int leaf : { 4u, 0x8000001Du })
+		{
+			if ((leaf < 0x80000000 ? max_leaf : max_extended_leaf) < leaf)
+				continue;
+
+			for (unsigned int subleaf = 0; subleaf < 16; subleaf++)
+			{
+				cpuid(leaf, subleaf, regs);
+
+				const unsigned int type = regs[0] & 0x1F;
+				if (type == 0)
+					break;
+
+				// 2 is an instruction cache
+				if (type == 2)
+					continue;
+
+				const int64_t ways = ((regs[1] >> 22) & 0x3FF) + 1;
+				const int64_t partitions = ((regs[1] >> 12) & 0x3FF) + 1;
+				const int64_t line_size = (regs[1] & 0xFFF) + 1;
+				const int64_t sets = int64_t(regs[2]) + 1;
+
+				levels.push_back({ int((regs[0] >> 5) & 0x7), ways * partitions * line_size * sets });
+			}
+
+			if (!levels.empty())
+				break;
+		}
+#endif
+
+		return levels;
+	}
+
+	// Read once, sorted by level
+	inline const std::vector<CacheLevel>& getCacheLevels()
+	{
+		static const std::vector<CacheLevel> levels = []
+		{
+			std::vector<CacheLevel> result = readSysfsCacheLevels();
+
+			if (result.empty())
+				result = readCpuidCacheLevels();
+
+			std::ranges::sort(result, {}, &CacheLevel::level);
+			return result;
+		}();
+
+		return levels;
+	}
+
+	// Empty when the cache sizes cannot be read
+	inline std::vector<int64_t> createCacheSweep(const BenchConfig::CacheSweep& sweep)
+	{
+		const std::vector<CacheLevel>& levels = getCacheLevels();
+
+		if (levels.empty())
+			return {};
+
+		const int points = std::max(sweep.points_per_level.value_or(9), 1);
+		const double spread = std::max(sweep.spread.value_or(2.0), 1.0);
+
+		// Multiples of the cache line size, geometric steps
+		std::set<int64_t> sizes;
+
+		for (const CacheLevel& level : levels)
+		{
+			for (int point = 0; point < points; point++)
+			{
+				const double exponent = points > 1 ? 2.0 * point / (points - 1) - 1.0 : 0.0;
+				const int64_t size = int64_t(std::llround(double(level.size) * std::pow(spread, exponent) / 64.0)) * 64;
+
+				sizes.insert(std::max<int64_t>(size, 64));
+			}
+		}
+
+		sizes.insert(sweep.dram_size.value_or(levels.back().size * 8));
+
+		return std::vector<int64_t>(sizes.begin(), sizes.end());
+	}
 }
 
 //// Config reflector
@@ -382,12 +628,13 @@ namespace rfl
 
 		static BaseType* to(const ReflType& config) noexcept
 		{
-			//auto& args = config.args.get().get();
 			auto& name = config.name.get().get();
 			auto& function = config.function.get().get();
 			auto& time_unit = config.time_unit.get().get();
 			auto& value_range = config.value_range.get().get();
 			auto& value_range_list = config.value_range_list.get().get();
+			auto& cache_sweep = config.cache_sweep.get().get();
+			auto& args = config.args.get().get();
 			auto& range_multiplier = config.range_multiplier.get().get();
 			auto& min_time = config.min_time.get().get();
 			auto& min_warmup_time = config.min_warmup_time.get().get();
@@ -398,65 +645,65 @@ namespace rfl
 			auto& complexity = config.complexity.get().get();
 			auto& threads = config.threads.get().get();
 			auto& thread_range = config.thread_range.get().get();
+			auto& use_real_time = config.use_real_time.get().get();
 
 			BaseType* base = new benchmark::internal::FunctionBenchmark(name.value(), reinterpret_cast<benchmark::internal::Function*>(function.value()));
 
-			//if (args.has_value())
-			//	base->Args(args.value());
-
-			//if (args.has_value())
-			//{
-			//	auto& args_value = args.value();
-			//
-			//	//for (size_t i = 0; i < args_value.size(); i++)
-			//	//	fmt::println("name {}, value {}", args_value[i].name, args_value[i].value);
-			//
-			//	auto values = args_value
-			//		| std::views::transform(&benchcfg::BenchConfig::Arg::value) 
-			//		| std::ranges::to<std::vector<int64_t>>();
-			//
-			//	auto names = args_value 
-			//		| std::views::transform(&benchcfg::BenchConfig::Arg::name) 
-			//		| std::ranges::to<std::vector<std::string>>();
-			//
-			//	base->Args(values);
-			//	base->ArgNames(names);
-			//}
-
-			//if (args.has_value())
-			//{
-			//	auto& args_value = args.value();
-			//
-			//	std::vector<int64_t> values(args_value.size());
-			//	std::vector<std::string> names(args_value.size());
-			//
-			//	for (auto [idx, arg] : std::views::enumerate(args_value))
-			//	{
-			//		values[idx] = arg.value;
-			//
-			//		if (arg.name.has_value())
-			//			names[idx] = arg.name.value();					
-			//	}
-			//
-			//
-			//	base->Args(values);
-			//	base->ArgNames(names);
-			//}
-
 			if (time_unit.has_value())
 				base->Unit(time_unit.value());
 
-			if (value_range.step.has_value())
-				base->DenseRange(value_range.start, value_range.limit, value_range.step.value());
-			else
-				base->Range(value_range.start, value_range.limit);
-
-			if (value_range_list.has_value())
-				base->Ranges(value_range_list.value());
-
+			// The multiplier is read when the ranges are expanded, so it goes first
 			if (range_multiplier.has_value())
 				base->RangeMultiplier(range_multiplier.value());
 
+			if (args.has_value())
+			{
+				std::vector<std::vector<int64_t>> arg_lists;
+				std::vector<std::string> arg_names;
+
+				for (const benchcfg::BenchConfig::Arg& arg : args.value())
+				{
+					std::vector<int64_t> values = arg.values.value_or(std::vector<int64_t>{});
+
+					if (arg.range.has_value())
+					{
+						auto& range = arg.range.value();
+						std::vector<int64_t> range_values = range.step.has_value()
+							? benchmark::CreateDenseRange(range.start, range.limit, range.step.value())
+							: benchmark::CreateRange(range.start, range.limit, range_multiplier.value_or(8));
+
+						values.insert(values.end(), range_values.begin(), range_values.end());
+					}
+
+					if (arg.cache_sweep.has_value())
+					{
+						std::vector<int64_t> sweep_values = benchcfg::createCacheSweep(arg.cache_sweep.value());
+						values.insert(values.end(), sweep_values.begin(), sweep_values.end());
+					}
+
+					arg_lists.push_back(std::move(values));
+					arg_names.push_back(arg.name);
+				}
+
+				base->ArgsProduct(arg_lists);
+				base->ArgNames(arg_names);
+			}
+			else if (std::vector<int64_t> sweep = cache_sweep.has_value() ? benchcfg::createCacheSweep(cache_sweep.value()) : std::vector<int64_t>{}; !sweep.empty())
+			{
+				base->ArgsProduct({ sweep });
+			}
+			else if (value_range_list.has_value())
+			{
+				base->Ranges(value_range_list.value());
+			}
+			else if (value_range.has_value())
+			{
+				if (value_range.value().step.has_value())
+					base->DenseRange(value_range.value().start, value_range.value().limit, value_range.value().step.value());
+				else
+					base->Range(value_range.value().start, value_range.value().limit);
+			}
+
 			if (min_time.has_value())
 				base->MinTime(min_time.value());
 
@@ -489,6 +736,9 @@ namespace rfl
 					base->ThreadRange(thread_range.value().min_threads, thread_range.value().max_threads);
 			}
 
+			if (use_real_time.has_value() && use_real_time.value())
+				base->UseRealTime();
+
 			return base;
 		}
 
@@ -1,4 +1,5 @@
 #include <cstdlib>
+#include <cstring>
 
 #include <string>
 #include <string_view>
@@ -8,11 +9,32 @@
 #include <charconv>
 #include <random>
 #include <memory>
+#include <optional>
 #include <memory_resource>
 #include <codecvt>
 #include <algorithm>
+#include <numeric>
 #include <execution>
 #include <span>
+#include <utility>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <list>
+#include <mutex>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #define FMT_STATIC
 #define FMT_UNICODE 0
@@ -25,46 +47,124 @@
 
 #include "..\BenchConfigCpp\bench-config.h"
 
-#define IMGUI_ENABLE_AVX2_IMMEMCHR
 #include "immemchr.h"
+#include "imlineindex.h"
+#include "imparallel.h"
+#include "imfilescan.h"
+#include "imlinestream.h"
+#include "impages.h"
+#include "imperfcounters.h"
+
+
+// Page size of the TestData buffers, page_size in bench_config.json
+static size_t buffer_page_length = IMGUI_SMALL_PAGE_LENGTH;
+
+// Never destroyed, the static TestData of the threaded benchmarks may outlive function-local statics
+static std::pmr::memory_resource* get_buffer_resource()
+{
+  static ImPageMemoryResource* small_pages = new ImPageMemoryResource(IMGUI_SMALL_PAGE_LENGTH);
+  static ImPageMemoryResource* huge_pages = new ImPageMemoryResource(IMGUI_HUGE_PAGE_LENGTH);
+
+  return buffer_page_length > IMGUI_SMALL_PAGE_LENGTH ? huge_pages : small_pages;
+}
+
+// Seed of the generated buffers, dataset_seed in bench_config.json
+static uint64_t test_data_seed = 42;
+
+// Bumped whenever gen_rand_ascii or the line layout changes, so stored datasets are generated again
+static const uint32_t TEST_DATA_GENERATOR_VERSION = 1;
+
+// Bytes generated per parallel task, each one seeds the generator with its own byte offset
+static const size_t RANDOM_ASCII_BLOCK_SIZE = 64 * 1024;
+
+static uint64_t splitmix64(uint64_t x)
+{
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+// 16 bits per byte mapped to [32, 126] by multiply-shift, uniform within 0.2% without a rejection loop
+static char rand_ascii_char(uint64_t bits)
+{
+  return static_cast<char>(32 + (((bits & 0xFFFF) * 95) >> 16));
+}
 
+// Random byte at any offset, the same gen_rand_ascii writes there
+static char rand_ascii_at(size_t offset, uint64_t seed)
+{
+  return rand_ascii_char(splitmix64(splitmix64(seed) + offset / 4) >> (16 * (offset % 4)));
+}
+
+// Counter-based: the 4 bytes at offset 4 * k are mixed from (seed, k) only, so every block is generated on
+// its own thread and the output is the same for any thread count and run
+static void gen_rand_ascii(char* buf, size_t size, uint64_t seed)
+{
+  const size_t block_count = (size + RANDOM_ASCII_BLOCK_SIZE - 1) / RANDOM_ASCII_BLOCK_SIZE;
+  const uint64_t stream = splitmix64(seed);
+
+  auto view = std::views::iota(size_t(0), block_count);
+  auto l = [&](size_t block)
+  {
+    const size_t begin = block * RANDOM_ASCII_BLOCK_SIZE;
+    const size_t end = std::min(begin + RANDOM_ASCII_BLOCK_SIZE, size);
+
+    for (size_t i = begin; i < end; i += 4)
+    {
+      uint64_t bits = splitmix64(stream + i / 4);
 
+      for (size_t j = 0; j < 4 && i + j < end; j++, bits >>= 16)
+        buf[i + j] = rand_ascii_char(bits);
+    }
+  };
+
+  std::for_each(std::execution::par_unseq, view.begin(), view.end(), l);
+}
+
+// One page-aligned buffer from get_buffer_resource, written once by the generator instead of zero-filled first.
+// Newlines are written in place over the random bytes and the clip only shortens the view, so a 1 GB dataset
+// holds 1 GB. The buffer keeps a NUL after its last byte for the C string searchers.
 class TestData
 {
 public:
-  TestData(size_t init_size, size_t clip_size = 0, size_t line_size = 0)
-    : init_size(init_size), clip_size(clip_size), line_size(line_size), str()
+  TestData(size_t init_size, size_t clip_size = 0, size_t line_size = 0, uint64_t seed = test_data_seed)
+    : init_size(init_size), clip_size(clip_size), line_size(line_size), seed(seed), str(init_size + 1, get_buffer_resource())
   {
-    str.resize(init_size);
-    gen_rand_ascii();
-
-    lined_str.resize(init_size - clip_size);
-    std::copy(str.data(), str.data() + str.size() - clip_size, lined_str.data());
+    gen_rand_ascii(str.GetData(), init_size, seed);
+    str.GetData()[init_size] = '\0';
     set_lines();
   }
 
   void changeClipSize(size_t clip_size)
   {
-    if (clip_size != this->clip_size)
-    {
-      this->clip_size = clip_size;
-      lined_str.resize(init_size - clip_size);
-    }
+    this->clip_size = clip_size;
   }
 
+  // Only the bytes at the old and new line starts are written, the old ones get their random byte back
   void changeLineSize(size_t line_size)
   {
     if (line_size != this->line_size)
     {
+      clear_lines();
       this->line_size = line_size;
-      std::copy(str.data(), str.data() + str.size() - clip_size, lined_str.data());
       set_lines();
     }
   }
 
   std::string_view get_str() const
   {
-    return lined_str;
+    return std::string_view(str.GetData(), init_size - clip_size);
+  }
+
+  void set_char(size_t pos, char ch)
+  {
+    str.GetData()[pos] = ch;
+  }
+
+  size_t get_memory_usage() const
+  {
+    return str.GetSize();
   }
 
   void print() const
@@ -75,39 +175,495 @@ public:
   }
 
 private:
-  void gen_rand_ascii()
+  template <class Fn>
+  void for_each_line_start(Fn fn)
   {
-    static thread_local std::mt19937 rng(42);
-    static thread_local std::uniform_int_distribution<int> dist(32, 126);
-    auto l = [&](char& c) { c = static_cast<char>(dist(rng)); };
-    std::for_each(std::execution::par_unseq, str.begin(), str.end(), l);
+    if (line_size == 0)
+      return;
+
+    auto view = std::views::iota(size_t(0), (init_size + line_size - 1) / line_size);
+    std::for_each(std::execution::par_unseq, view.begin(), view.end(), [&](size_t line) { fn(line * line_size); });
   }
 
   void set_lines()
   {
-    //if (line_size != 0)
-    //{
-    //  size_t count = lined_str.size() / line_size;
-    //  auto view = std::views::iota(size_t(0), count);
-    //  auto l = [&](size_t k) { lined_str[k * line_size] = '\n'; };
-    //  std::for_each(std::execution::par, view.begin(), view.end(), l);
-    //}
+    char* buf = str.GetData();
+    for_each_line_start([&](size_t pos) { buf[pos] = '\n'; });
+  }
 
-    for (size_t i = 0; i < lined_str.size(); i+= line_size)
-    {
-      lined_str[i] = '\n';
-    }
+  void clear_lines()
+  {
+    char* buf = str.GetData();
+    for_each_line_start([&](size_t pos) { buf[pos] = rand_ascii_at(pos, seed); });
   }
 
 private:
   size_t init_size;
   size_t clip_size;
   size_t line_size;
+  uint64_t seed;
+
+  ImPageBuffer str;
+};
+
+// Directory of the on-disk dataset store, dataset_dir in bench_config.json, empty when unset to always generate
+static fs::path dataset_dir;
+
+// Order-independent 64-bit checksum of 64 KB blocks, computed in parallel
+static uint64_t dataset_checksum(const char* buf, size_t size)
+{
+  const size_t block_count = (size + RANDOM_ASCII_BLOCK_SIZE - 1) / RANDOM_ASCII_BLOCK_SIZE;
+  auto view = std::views::iota(size_t(0), block_count);
+
+  return std::transform_reduce(std::execution::par_unseq, view.begin(), view.end(), uint64_t(0), std::plus<>(), [&](size_t block)
+  {
+    const size_t begin = block * RANDOM_ASCII_BLOCK_SIZE;
+    const size_t end = std::min(begin + RANDOM_ASCII_BLOCK_SIZE, size);
+    uint64_t hash = block;
+
+    for (size_t i = begin; i < end; i += 8)
+    {
+      uint64_t word = 0;
+      std::memcpy(&word, buf + i, std::min<size_t>(8, end - i));
+      hash = splitmix64(hash ^ word);
+    }
+
+    return hash;
+  });
+}
+
+// Generated datasets written to dataset_dir and memory-mapped read-only by later runs. A file holds one page of
+// header, so the data stays page-aligned, then the data and a NUL. A header that does not match the
+// requested parameters, the generator version or the checksum is ignored and the file is written again.
+class DatasetStore
+{
+public:
+  struct Header
+  {
+    char magic[8];
+    uint32_t generator_version;
+    uint32_t header_size;
+    uint64_t seed;
+    uint64_t size;
+    uint64_t clip_size;
+    uint64_t line_size;
+    uint64_t checksum;
+  };
+
+  static const size_t HEADER_SIZE = IMGUI_SMALL_PAGE_LENGTH;
+
+  static std::unique_ptr<ImFileLineScanner> load(size_t size, size_t clip_size, size_t line_size, uint64_t seed)
+  {
+    if (dataset_dir.empty())
+      return nullptr;
+
+    // Searched many times over, not once front to back
+    ImFileLineScannerSettings settings;
+    settings.sequential = false;
+
+    auto file = std::make_unique<ImFileLineScanner>(get_path(size, clip_size, line_size).string().c_str(), settings);
+    const size_t data_size = size - clip_size + 1;
+
+    if (!file->IsOpen() || file->GetSize() != HEADER_SIZE + data_size)
+      return nullptr;
+
+    Header header;
+    std::memcpy(&header, file->GetData(), sizeof(header));
+
+    const Header expected = make_header(size, clip_size, line_size, seed, header.checksum);
+
+    if (std::memcmp(&header, &expected, sizeof(header)) != 0)
+      return nullptr;
+
+    if (file->GetData()[HEADER_SIZE + data_size - 1] != '\0' || dataset_checksum(file->GetData() + HEADER_SIZE, data_size - 1) != header.checksum)
+      return nullptr;
+
+    return file;
+  }
+
+  static void save(const TestData& data, size_t size, size_t clip_size, size_t line_size, uint64_t seed)
+  {
+    if (dataset_dir.empty())
+      return;
+
+    std::error_code error;
+    fs::create_directories(dataset_dir, error);
+
+    // A NUL is stored after the data, a clipped view of a TestData is followed by more data instead
+    const std::string_view str = data.get_str();
+
+    std::vector<char> header_page(HEADER_SIZE);
+    const Header header = make_header(size, clip_size, line_size, seed, dataset_checksum(str.data(), str.size()));
+    std::memcpy(header_page.data(), &header, sizeof(header));
+
+    // Written under a temporary name and renamed, a run stopped halfway never leaves a truncated dataset behind
+    const fs::path path = get_path(size, clip_size, line_size);
+    fs::path temp_path = path;
+    temp_path += ".tmp";
+
+    {
+      std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+      file.write(header_page.data(), header_page.size());
+      file.write(str.data(), str.size());
+      file.put('\0');
+
+      if (!file)
+      {
+        file.close();
+        fs::remove(temp_path, error);
+        return;
+      }
+    }
+
+    fs::rename(temp_path, path, error);
+  }
+
+private:
+  static Header make_header(size_t size, size_t clip_size, size_t line_size, uint64_t seed, uint64_t checksum)
+  {
+    Header header = {};
+    std::memcpy(header.magic, "IMDATA\0\0", sizeof(header.magic));
+    header.generator_version = TEST_DATA_GENERATOR_VERSION;
+    header.header_size = (uint32_t)HEADER_SIZE;
+    header.seed = seed;
+    header.size = size;
+    header.clip_size = clip_size;
+    header.line_size = line_size;
+    header.checksum = checksum;
+    return header;
+  }
+
+  // One file per shape, a new seed or generator version overwrites it
+  static fs::path get_path(size_t size, size_t clip_size, size_t line_size)
+  {
+    return dataset_dir / fmt::format("testdata_{}_{}_{}.bin", size, clip_size, line_size);
+  }
+};
+
+// Whole lines of a corpus copied end to end into a page buffer of at most size bytes, so every seam is a line
+// boundary. The last copy is cut after a line end, the buffer may hold a bit less than size.
+class TiledCorpus
+{
+public:
+  TiledCorpus(std::string_view corpus, size_t size)
+    : str(size + 1, get_buffer_resource())
+  {
+    // A trailing partial line would be joined with the first line of the next copy
+    if (size_t last_line_end = corpus.rfind('\n'); last_line_end != std::string_view::npos)
+      corpus = corpus.substr(0, last_line_end + 1);
+
+    const size_t copies = size / corpus.size();
+    const size_t tail_end = corpus.substr(0, size % corpus.size()).rfind('\n');
+    const size_t tail_size = tail_end != std::string_view::npos ? tail_end + 1 : copies ? 0 : size;
+
+    auto view = std::views::iota(size_t(0), copies);
+    std::for_each(std::execution::par_unseq, view.begin(), view.end(), [&](size_t copy)
+    {
+      std::memcpy(str.GetData() + copy * corpus.size(), corpus.data(), corpus.size());
+    });
+
+    std::memcpy(str.GetData() + copies * corpus.size(), corpus.data(), tail_size);
+    tiled_size = copies * corpus.size() + tail_size;
+    str.GetData()[tiled_size] = '\0';
+  }
+
+  std::string_view get_str() const
+  {
+    return std::string_view(str.GetData(), tiled_size);
+  }
+
+  size_t get_memory_usage() const
+  {
+    return str.GetSize();
+  }
+
+private:
+  ImPageBuffer str;
+  size_t tiled_size = 0;
+};
+
+// Read-only dataset of the cache: generated in memory, mapped from the dataset store, or a tiled corpus
+struct CachedDataset
+{
+  std::unique_ptr<TestData> generated;
+  std::unique_ptr<ImFileLineScanner> mapped;
+  std::unique_ptr<TiledCorpus> tiled;
+
+  std::string_view get_str() const
+  {
+    if (mapped)
+      return std::string_view(mapped->GetData() + DatasetStore::HEADER_SIZE, mapped->GetSize() - DatasetStore::HEADER_SIZE - 1);
+
+    return tiled ? tiled->get_str() : generated->get_str();
+  }
+
+  size_t get_memory_usage() const
+  {
+    return mapped ? mapped->GetSize() : tiled ? tiled->get_memory_usage() : generated->get_memory_usage();
+  }
+};
+
+// Bytes of generated datasets kept for the next benchmarks, dataset_cache_size in bench_config.json
+static size_t dataset_cache_budget = size_t(4) << 30;
+
+// Read-only datasets shared by every benchmark asking for the same parameters, so each kernel of a sweep
+// searches the same buffer instead of generating its own. The least recently used ones are dropped first.
+// A generated dataset no benchmark holds is reused for another line or clip size of the same size and seed,
+// only its line starts are rewritten, so a sweep over line and clip sizes keeps one buffer per size.
+// A missing dataset is mapped from the dataset store, or generated, stored and mapped back. The store is
+// skipped with huge pages, the page cache backs mapped files with small pages.
+// Tiled corpora are cached the same way, keyed by their corpus slot. Benchmarks that write into their data
+// build a TestData.
+class DatasetCache
+{
+public:
+  std::shared_ptr<const CachedDataset> get(size_t size, size_t clip_size, size_t line_size, uint64_t seed)
+  {
+    return find_or_add({ size, clip_size, line_size, seed, NO_CORPUS }, [&](CachedDataset& data) { generate(data, size, clip_size, line_size, seed); });
+  }
+
+  std::shared_ptr<const CachedDataset> get_corpus(size_t corpus_slot, std::string_view corpus, size_t size)
+  {
+    return find_or_add({ size, 0, 0, 0, corpus_slot }, [&](CachedDataset& data) { data.tiled = std::make_unique<TiledCorpus>(corpus, size); });
+  }
+
+private:
+  static const size_t NO_CORPUS = ~size_t(0);
+
+  struct Key
+  {
+    size_t size;
+    size_t clip_size;
+    size_t line_size;
+    uint64_t seed;
+    size_t corpus_slot;
+
+    bool operator==(const Key&) const = default;
+  };
+
+  struct Entry
+  {
+    Key key;
+    std::shared_ptr<CachedDataset> data;
+  };
+
+  template <class Fn>
+  std::shared_ptr<const CachedDataset> find_or_add(const Key& key, Fn make)
+  {
+    std::lock_guard lock(mutex);
+
+    auto it = std::find_if(entries.begin(), entries.end(), [&](const Entry& entry) { return entry.key == key; });
+
+    if (it == entries.end() && key.corpus_slot == NO_CORPUS)
+    {
+      // The cache holds the only reference, so no benchmark sees its data change
+      it = std::find_if(entries.begin(), entries.end(), [&](const Entry& entry)
+      {
+        return entry.key.size == key.size && entry.key.seed == key.seed && entry.key.corpus_slot == NO_CORPUS && entry.data->generated && entry.data.use_count() == 1;
+      });
+
+      if (it != entries.end())
+      {
+        it->data->generated->changeLineSize(key.line_size);
+        it->data->generated->changeClipSize(key.clip_size);
+        it->key = key;
+      }
+    }
+
+    if (it != entries.end())
+    {
+      entries.splice(entries.begin(), entries, it);
+      return entries.front().data;
+    }
+
+    auto data = std::make_shared<CachedDataset>();
+    make(*data);
+
+    entries.push_front({ key, std::move(data) });
+    cached_bytes += entries.front().data->get_memory_usage();
+
+    // A dataset still used by a benchmark is released with its last reference
+    while (cached_bytes > dataset_cache_budget && entries.size() > 1)
+    {
+      cached_bytes -= entries.back().data->get_memory_usage();
+      entries.pop_back();
+    }
+
+    return entries.front().data;
+  }
+
+  static void generate(CachedDataset& data, size_t size, size_t clip_size, size_t line_size, uint64_t seed)
+  {
+    const bool use_store = buffer_page_length == IMGUI_SMALL_PAGE_LENGTH;
+
+    if (use_store)
+      data.mapped = DatasetStore::load(size, clip_size, line_size, seed);
+
+    if (!data.mapped)
+    {
+      data.generated = std::make_unique<TestData>(size, clip_size, line_size, seed);
+
+      // The buffer is replaced by its stored copy, so this run measures the same mapped memory as the next ones
+      if (use_store)
+      {
+        DatasetStore::save(*data.generated, size, clip_size, line_size, seed);
+
+        if (auto mapped = DatasetStore::load(size, clip_size, line_size, seed))
+        {
+          data.generated.reset();
+          data.mapped = std::move(mapped);
+        }
+      }
+    }
+  }
+
+  std::mutex mutex;
+  std::list<Entry> entries;
+  size_t cached_bytes = 0;
+};
+
+static DatasetCache& get_dataset_cache()
+{
+  static DatasetCache cache;
+  return cache;
+}
+
+// Generation, mapping, line rewrite or cache lookup time is reported as setup_s, it is not part of the measured time
+static std::shared_ptr<const CachedDataset> get_test_data(benchmark::State& state, size_t size, size_t clip_size = 0, size_t line_size = 0)
+{
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<const CachedDataset> data = get_dataset_cache().get(size, clip_size, line_size, test_data_seed);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  state.counters["setup_s"] = elapsed.count();
+  return data;
+}
+
+// Peak resident memory since the previous report, so each benchmark shows its own peak including its setup.
+// Linux resets the peak through /proc/self/clear_refs, Windows cannot reset it and shows the peak of the run so far.
+static void report_peak_rss(benchmark::State& state)
+{
+  size_t peak_rss = 0;
+
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    peak_rss = counters.PeakWorkingSetSize;
+#else
+  std::ifstream status("/proc/self/status");
+  std::string line;
+
+  while (std::getline(status, line))
+  {
+    if (line.starts_with("VmHWM:"))
+    {
+      peak_rss = size_t(std::strtoull(line.c_str() + 6, nullptr, 10)) * 1024;
+      break;
+    }
+  }
+
+  std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+
+  state.counters["peak_rss"] = benchmark::Counter(double(peak_rss), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+
+// Hardware events counted around the timed loop of the line benchmarks, perf_counters in bench_config.json
+static std::vector<std::string> perf_counter_events;
+
+// Counts perf_counter_events from construction to report, which adds them per iteration along with the IPC and
+// the cycles per byte. Without counters the benchmark reports its time only.
+class BenchPerfCounters
+{
+public:
+  BenchPerfCounters()
+  {
+    if (!perf_counter_events.empty() && counters.Open(perf_counter_events))
+      counters.Start();
+  }
+
+  void report(benchmark::State& state, size_t bytes_per_iteration)
+  {
+    if (!counters.Stop())
+      return;
+
+    for (size_t i = 0; i < counters.GetCount(); i++)
+    {
+      if (counters.HasValue(i))
+        state.counters[counters.GetName(i)] = benchmark::Counter(double(counters.GetValue(i)), benchmark::Counter::kAvgIterations);
+    }
+
+    const double cycles = double(counters.GetValue("cycles"));
+    const double instructions = double(counters.GetValue("instructions"));
+
+    if (cycles > 0 && instructions > 0)
+      state.counters["IPC"] = instructions / cycles;
 
-  std::string str;
-  std::string lined_str;
+    if (cycles > 0 && bytes_per_iteration > 0)
+      state.counters["cycles_per_byte"] = cycles / (double(state.iterations()) * double(bytes_per_iteration));
+  }
+
+private:
+  ImPerfCounters counters;
 };
 
+// Application log look-alike: timestamp, level and thread, then a message of log-normal length
+// (median about 55 bytes), rare long payload lines and bursts of short stack trace lines.
+static std::string generate_log_corpus(size_t size)
+{
+  static const char* const levels[] = { "INFO ", "DEBUG", "TRACE", "WARN ", "ERROR" };
+
+  std::mt19937 rng(42);
+  std::discrete_distribution<int> level(std::initializer_list<double>{ 60, 25, 8, 5, 2 });
+  std::uniform_int_distribution<int> thread(1, 16);
+  std::uniform_int_distribution<int> word_length(2, 10);
+  std::uniform_int_distribution<int> letter('a', 'z');
+  std::lognormal_distribution<double> message_length(4.0, 0.7);
+  std::lognormal_distribution<double> payload_length(6.5, 0.5);
+  std::bernoulli_distribution payload(0.02);
+  std::bernoulli_distribution stack_trace(0.01);
+  std::uniform_int_distribution<int> stack_depth(5, 20);
+
+  std::string text;
+  text.reserve(size + 8192);
+
+  auto append_words = [&](size_t length)
+  {
+    for (size_t end = text.size() + length; text.size() < end;)
+    {
+      for (int k = word_length(rng); k > 0; k--)
+        text.push_back((char)letter(rng));
+
+      text.push_back(' ');
+    }
+
+    text.back() = '\n';
+  };
+
+  for (uint64_t ms = 0; text.size() < size; ms += 1 + rng() % 50)
+  {
+    char prefix[64];
+    int prefix_length = snprintf(prefix, sizeof(prefix), "2024-05-01 %02u:%02u:%02u.%03u %s [worker-%02d] ",
+                                 unsigned(ms / 3600000 % 24), unsigned(ms / 60000 % 60), unsigned(ms / 1000 % 60), unsigned(ms % 1000),
+                                 levels[level(rng)], thread(rng));
+    text.append(prefix, prefix_length);
+
+    append_words(size_t(payload(rng) ? payload_length(rng) : message_length(rng)) + 1);
+
+    if (stack_trace(rng))
+    {
+      for (int depth = stack_depth(rng); depth > 0; depth--)
+      {
+        text.append("    at ");
+        append_words(size_t(24 + rng() % 48));
+      }
+    }
+  }
+
+  text.resize(size);
+  return text;
+}
+
 template <auto MemchrFunc = ImMemchr>
 size_t all_lines(const char* buf, size_t size)
 {
@@ -127,68 +683,2143 @@ size_t all_lines(const char* buf, size_t size)
   return ptr - buf;
 }
 
+template <class Callback>
+using MemchrAllFuncT = size_t(const void*, int, size_t, Callback&&);
 
-using MemchrFuncT = decltype(ImMemchr);
-template <MemchrFuncT MemchrFunc = ImMemchr>
-static void BM_AllLines(benchmark::State& state)
+struct AllMatchesSink
 {
-  size_t size = state.range(0);
+  size_t last = 0;
+
+  void operator()(size_t offset)
+  {
+    last = offset;
+  }
+};
 
-  TestData data(size, 0, 131);
+template <MemchrAllFuncT<AllMatchesSink&> MemchrAllFunc>
+size_t all_matches(const char* buf, size_t size)
+{
+  AllMatchesSink sink;
+  size_t found = MemchrAllFunc(buf, '\n', size, sink);
 
-  std::string_view strv = data.get_str();
-  const char* buf = strv.data();
-  size_t buf_size = strv.size();
+  return found ? sink.last + 1 : 0;
+}
 
-  for (auto _ : state)
+
+using MemchrFuncT = decltype(ImMemchr);
+using MemcountFuncT = decltype(ImMemcount);
+using MemchrNthFuncT = decltype(ImMemchrNth);
+
+// Best of several timed passes over the whole buffer, in bytes per second
+static double measure_scan(ImMemchrFunc func, const char* buf, size_t size)
+{
+  const size_t scans_per_pass = std::max<size_t>(1, (64 << 20) / size);
+  double best = 0;
+
+  for (int pass = 0; pass < 5; pass++)
   {
-    benchmark::DoNotOptimize(all_lines<MemchrFunc>(buf, buf_size));
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < scans_per_pass; i++)
+      benchmark::DoNotOptimize(func(buf, '\n', size));
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::max(best, double(size * scans_per_pass) / elapsed.count());
   }
 
-  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  return best;
 }
 
-auto BM_AllLines_AVX512_PREFETCH        = BM_AllLines<ImMemchrAVX512_PREFETCH>;
-auto BM_AllLines_AVX512                 = BM_AllLines<ImMemchrAVX512>;
+// Read bandwidth ceiling: every byte loaded and ORed into four independent accumulators, nothing compared.
+// Same signature as the search kernels so measure_scan times it, returns buf unless the buffer is all zero.
+IMGUI_TARGET_AVX512 static const void* read_all_avx512(const void* buf, int, size_t size)
+{
+  const char* ptr = (const char*)buf;
+  const char* end = ptr + size;
+  __m512i acc0 = _mm512_setzero_si512(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
 
-auto BM_AllLines_AVX2_UNROLL_PREFETCH   = BM_AllLines<ImMemchrAVX2_UNROLL_PREFETCH>;
-auto BM_AllLines_AVX2_UNROLL            = BM_AllLines<ImMemchrAVX2_UNROLL>;
-auto BM_AllLines_AVX2_PREFETCH          = BM_AllLines<ImMemchrAVX2_PREFETCH>;
-auto BM_AllLines_AVX2                   = BM_AllLines<ImMemchrAVX2>;
+  for (; ptr + 256 <= end; ptr += 256)
+  {
+    acc0 = _mm512_or_si512(acc0, _mm512_loadu_si512(ptr));
+    acc1 = _mm512_or_si512(acc1, _mm512_loadu_si512(ptr + 64));
+    acc2 = _mm512_or_si512(acc2, _mm512_loadu_si512(ptr + 128));
+    acc3 = _mm512_or_si512(acc3, _mm512_loadu_si512(ptr + 192));
+  }
 
-auto BM_AllLines_SSE4_2_UNROLL_PREFETCH = BM_AllLines<ImMemchrSSE4_2_UNROLL_PREFETCH>;
-auto BM_AllLines_SSE4_2_UNROLL          = BM_AllLines<ImMemchrSSE4_2_UNROLL>;
-auto BM_AllLines_SSE4_2_PREFETCH        = BM_AllLines<ImMemchrSSE4_2_PREFETCH>;
-auto BM_AllLines_SSE4_2                 = BM_AllLines<ImMemchrSSE4_2>;
+  uint64_t tail = 0;
+  for (; ptr < end; ptr++)
+    tail |= (unsigned char)*ptr;
 
-auto BM_AllLines_SSE_UNROLL_PREFETCH    = BM_AllLines<ImMemchrSSE_UNROLL_PREFETCH>;
-auto BM_AllLines_SSE_UNROLL             = BM_AllLines<ImMemchrSSE_UNROLL>;
-auto BM_AllLines_SSE_PREFETCH           = BM_AllLines<ImMemchrSSE_PREFETCH>;
-auto BM_AllLines_SSE                    = BM_AllLines<ImMemchrSSE>;
+  const __m512i acc = _mm512_or_si512(_mm512_or_si512(acc0, acc1), _mm512_or_si512(acc2, acc3));
+  return _mm512_test_epi64_mask(acc, acc) != 0 || tail != 0 ? buf : nullptr;
+}
 
-auto BM_AllLines_CSTD                   = BM_AllLines<ImMemchrCSTD>;
+IMGUI_TARGET_AVX2 static const void* read_all_avx2(const void* buf, int, size_t size)
+{
+  const char* ptr = (const char*)buf;
+  const char* end = ptr + size;
+  __m256i acc0 = _mm256_setzero_si256(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
 
-static fs::path path = fs::current_path() / "bench_config.json";
-static benchcfg::ConfigLoader config_loader(path);
+  for (; ptr + 128 <= end; ptr += 128)
+  {
+    acc0 = _mm256_or_si256(acc0, _mm256_loadu_si256((const __m256i*)ptr));
+    acc1 = _mm256_or_si256(acc1, _mm256_loadu_si256((const __m256i*)(ptr + 32)));
+    acc2 = _mm256_or_si256(acc2, _mm256_loadu_si256((const __m256i*)(ptr + 64)));
+    acc3 = _mm256_or_si256(acc3, _mm256_loadu_si256((const __m256i*)(ptr + 96)));
+  }
+
+  uint64_t tail = 0;
+  for (; ptr < end; ptr++)
+    tail |= (unsigned char)*ptr;
 
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_AVX512_PREFETCH, "ImMemchr_AVX512_PREFETCH")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_AVX512, "ImMemchr_AVX512")
+  const __m256i acc = _mm256_or_si256(_mm256_or_si256(acc0, acc1), _mm256_or_si256(acc2, acc3));
+  return !_mm256_testz_si256(acc, acc) || tail != 0 ? buf : nullptr;
+}
+
+IMGUI_TARGET_SSE2 static const void* read_all_sse2(const void* buf, int, size_t size)
+{
+  const char* ptr = (const char*)buf;
+  const char* end = ptr + size;
+  __m128i acc0 = _mm_setzero_si128(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
 
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_AVX2_UNROLL_PREFETCH, "ImMemchr_AVX2_UNROLL_PREFETCH")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_AVX2_UNROLL, "ImMemchr_AVX2_UNROLL")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_AVX2_PREFETCH, "ImMemchr_AVX2_PREFETCH")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_AVX2, "ImMemchr_AVX2")
+  for (; ptr + 64 <= end; ptr += 64)
+  {
+    acc0 = _mm_or_si128(acc0, _mm_loadu_si128((const __m128i*)ptr));
+    acc1 = _mm_or_si128(acc1, _mm_loadu_si128((const __m128i*)(ptr + 16)));
+    acc2 = _mm_or_si128(acc2, _mm_loadu_si128((const __m128i*)(ptr + 32)));
+    acc3 = _mm_or_si128(acc3, _mm_loadu_si128((const __m128i*)(ptr + 48)));
+  }
+
+  uint64_t tail = 0;
+  for (; ptr < end; ptr++)
+    tail |= (unsigned char)*ptr;
+
+  const __m128i acc = _mm_or_si128(_mm_or_si128(acc0, acc1), _mm_or_si128(acc2, acc3));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(acc, _mm_setzero_si128())) != 0xFFFF || tail != 0 ? buf : nullptr;
+}
+
+// The widest loads of the CPU, the ceiling of every kernel whatever its own ISA
+static ImMemchrFunc select_read_all()
+{
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512))
+    return read_all_avx512;
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX2))
+    return read_all_avx2;
+  return read_all_sse2;
+}
+
+static volatile uint64_t cpu_hz_multiplier = 3;
+
+// Core clock from a chain of dependent multiply-adds, 4 cycles each (3 for imul, 1 for add) on current x86 cores
+static double measure_cpu_hz()
+{
+  const uint64_t multiplier = cpu_hz_multiplier;
+  const size_t chain_length = size_t(1) << 26;
+  double best = 0;
+
+  for (int pass = 0; pass < 5; pass++)
+  {
+    uint64_t x = 1;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < chain_length; i++)
+      x = x * multiplier + i;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    benchmark::DoNotOptimize(x);
+    best = std::max(best, 4.0 * double(chain_length) / elapsed.count());
+  }
+
+  return best;
+}
+
+static std::string get_host_name()
+{
+#if defined(_WIN32)
+  char name[MAX_COMPUTERNAME_LENGTH + 1];
+  DWORD length = sizeof(name);
+  return GetComputerNameA(name, &length) ? std::string(name, length) : std::string("localhost");
+#else
+  char name[256] = {};
+  return gethostname(name, sizeof(name) - 1) == 0 ? std::string(name) : std::string("localhost");
+#endif
+}
+
+// Read bandwidth ceiling per page size and buffer size, and the core clock of this host. Missing values are
+// measured on first use and saved to immemchr_roofline_<host>.ini for the next runs:
+// [Roofline]
+// CpuHz=3.2e+09
+// [Bandwidth][4096]
+// 1048576=5.1e+10
+class RooflineCalibration
+{
+public:
+  RooflineCalibration()
+    : path(fs::current_path() / ("immemchr_roofline_" + get_host_name() + ".ini"))
+  {
+    load();
+  }
+
+  // Bytes per second of the ceiling kernel over the same buffer the benchmark searches
+  double get_ceiling(const char* buf, size_t size)
+  {
+    double& ceiling = ceilings[{ buffer_page_length, size }];
+
+    if (ceiling == 0)
+    {
+      ceiling = measure_scan(select_read_all(), buf, size);
+      save();
+    }
+
+    return ceiling;
+  }
+
+  double get_cpu_hz()
+  {
+    if (cpu_hz == 0)
+    {
+      cpu_hz = measure_cpu_hz();
+      save();
+    }
+
+    return cpu_hz;
+  }
+
+private:
+  void load()
+  {
+    std::ifstream file(path);
+    std::string line;
+    size_t page_length = 0;
+
+    while (std::getline(file, line))
+    {
+      if (line.starts_with("CpuHz="))
+        cpu_hz = std::strtod(line.c_str() + 6, nullptr);
+      else if (line.starts_with("[Bandwidth]["))
+        page_length = (size_t)std::strtoull(line.c_str() + 12, nullptr, 10);
+      else if (page_length != 0 && line.find('=') != std::string::npos)
+        ceilings[{ page_length, (size_t)std::strtoull(line.c_str(), nullptr, 10) }] = std::strtod(line.c_str() + line.find('=') + 1, nullptr);
+    }
+  }
+
+  void save() const
+  {
+    std::ofstream file(path, std::ios::trunc);
+
+    file << "[Roofline]\n";
+    if (cpu_hz != 0)
+      file << "CpuHz=" << cpu_hz << "\n";
+
+    size_t page_length = 0;
+
+    for (const auto& [key, ceiling] : ceilings)
+    {
+      if (ceiling == 0)
+        continue;
+
+      if (key.first != page_length)
+      {
+        page_length = key.first;
+        file << "[Bandwidth][" << page_length << "]\n";
+      }
+
+      file << key.second << "=" << ceiling << "\n";
+    }
+  }
+
+private:
+  fs::path path;
+  double cpu_hz = 0;
+  std::map<std::pair<size_t, size_t>, double> ceilings;
+};
+
+// Reports the throughput as a percentage of the read ceiling over the same buffer, and the cycles per byte at
+// the calibrated clock when the perf counters did not measure them. Both are rates of the measured time.
+static void report_roofline(benchmark::State& state, const char* buf, size_t size)
+{
+  static RooflineCalibration calibration;
+
+  const double bytes = double(state.iterations()) * double(size);
+
+  state.counters["roofline_pct"] = benchmark::Counter(bytes / calibration.get_ceiling(buf, size) * 100, benchmark::Counter::kIsRate);
+
+  if (state.counters.find("cycles_per_byte") == state.counters.end())
+    state.counters["cycles_per_byte"] = benchmark::Counter(bytes / calibration.get_cpu_hz(), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// Arguments: buffer size, line size (0 for a buffer without newlines) and the bytes clipped off its end
+template <MemchrFuncT MemchrFunc = ImMemchr>
+static void BM_AllLines(benchmark::State& state)
+{
+  if (!ImMemchrIsSupported(MemchrFunc))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  size_t size = state.range(0);
+  size_t line_size = state.range(1);
+  size_t clip_size = state.range(2);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, clip_size, line_size);
+
+  std::string_view strv = data->get_str();
+  const char* buf = strv.data();
+  size_t buf_size = strv.size();
+
+  BenchPerfCounters perf_counters;
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(all_lines<MemchrFunc>(buf, buf_size));
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(buf_size));
+  perf_counters.report(state, buf_size);
+  report_roofline(state, buf, buf_size);
+  report_peak_rss(state);
+}
+
+template <class Isa, int Unroll, class PrefetchPolicy>
+static void BM_AllLinesKernel(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(Isa::REQUIRED))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  BM_AllLines<ImMemchrKernel<Isa, Unroll, PrefetchPolicy>>(state);
+}
+
+// Every length up to state.range(0) at every start alignment within a cache line: every byte a match, then a single
+// match at every position and no match. The bytes around each buffer are the searched value, so a kernel reading
+// past either end is caught. check(buf, length, matches) compares a kernel with the expected match offsets.
+template <class Check>
+static bool check_short_buffers(benchmark::State& state, Check&& check)
+{
+  const size_t max_length = state.range(0);
+  const size_t alignments = IMGUI_CACHE_LINE_LENGTH;
+
+  std::vector<char> storage(max_length + 3 * alignments);
+  char* base = (char*)(((uintptr_t)storage.data() + alignments - 1) & ~(uintptr_t)(alignments - 1)) + alignments;
+  std::vector<size_t> matches;
+
+  for (size_t alignment = 0; alignment < alignments; alignment++)
+  {
+    for (size_t length = 0; length <= max_length; length++)
+    {
+      char* buf = base + alignment;
+
+      std::fill(storage.begin(), storage.end(), '\n');
+      matches.resize(length);
+      std::iota(matches.begin(), matches.end(), size_t(0));
+
+      bool match = check((const char*)buf, length, (const std::vector<size_t>&)matches);
+
+      std::fill(buf, buf + length, 'a');
+
+      for (size_t pos = 0; pos <= length && match; pos++)
+      {
+        matches.clear();
+
+        if (pos < length)
+        {
+          buf[pos] = '\n';
+          matches.push_back(pos);
+        }
+
+        match = check((const char*)buf, length, (const std::vector<size_t>&)matches);
+
+        if (pos < length)
+          buf[pos] = 'a';
+      }
+
+      if (!match)
+      {
+        fmt::println("length {} at alignment {} differs from a byte loop", length, alignment);
+        state.SkipWithError("Result differs from a byte loop");
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// Calls run(buf, length) for every length and alignment of check_short_buffers, over buffers without a match
+template <class Run>
+static void time_short_buffers(benchmark::State& state, Run&& run)
+{
+  const size_t max_length = state.range(0);
+  const size_t alignments = IMGUI_CACHE_LINE_LENGTH;
+
+  std::vector<char> storage(max_length + 3 * alignments, '\n');
+  char* base = (char*)(((uintptr_t)storage.data() + alignments - 1) & ~(uintptr_t)(alignments - 1)) + alignments;
+
+  std::fill(base, base + alignments + max_length, 'a');
+
+  for (auto _ : state)
+  {
+    for (size_t alignment = 0; alignment < alignments; alignment++)
+    {
+      for (size_t length = 0; length <= max_length; length++)
+        benchmark::DoNotOptimize(run((const char*)base + alignment, length));
+    }
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(alignments * (max_length + 1)));
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(alignments * max_length * (max_length + 1) / 2));
+}
+
+template <MemchrFuncT MemchrFunc>
+static void BM_ShortBuffers(benchmark::State& state)
+{
+  if (!ImMemchrIsSupported(MemchrFunc))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  bool checked = check_short_buffers(state, [](const char* buf, size_t length, const std::vector<size_t>& matches)
+  {
+    return MemchrFunc(buf, '\n', length) == (matches.empty() ? nullptr : buf + matches.front());
+  });
+
+  if (checked)
+    time_short_buffers(state, [](const char* buf, size_t length) { return MemchrFunc(buf, '\n', length); });
+}
+
+// Collects the offsets passed by the ImMemchrAll kernels
+struct ShortBufferMatches
+{
+  std::vector<size_t> offsets;
+
+  void operator()(size_t offset)
+  {
+    offsets.push_back(offset);
+  }
+};
+
+template <MemchrAllFuncT<ShortBufferMatches&> MemchrAllFunc, ImCpuFeatureFlags RequiredFeatures>
+static void BM_ShortBuffersAll(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  ShortBufferMatches sink;
+  sink.offsets.reserve(state.range(0));
+
+  bool checked = check_short_buffers(state, [&](const char* buf, size_t length, const std::vector<size_t>& matches)
+  {
+    sink.offsets.clear();
+    size_t found = MemchrAllFunc(buf, '\n', length, sink);
+    return found == matches.size() && sink.offsets == matches;
+  });
+
+  if (checked)
+  {
+    time_short_buffers(state, [&](const char* buf, size_t length)
+    {
+      sink.offsets.clear();
+      return MemchrAllFunc(buf, '\n', length, sink);
+    });
+  }
+}
+
+template <MemcountFuncT MemcountFunc, ImCpuFeatureFlags RequiredFeatures>
+static void BM_ShortBuffersCount(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  bool checked = check_short_buffers(state, [](const char* buf, size_t length, const std::vector<size_t>& matches)
+  {
+    return MemcountFunc(buf, '\n', length) == matches.size();
+  });
+
+  if (checked)
+    time_short_buffers(state, [](const char* buf, size_t length) { return MemcountFunc(buf, '\n', length); });
+}
+
+// Every k up to one past the last match
+template <MemchrNthFuncT MemchrNthFunc, ImCpuFeatureFlags RequiredFeatures>
+static void BM_ShortBuffersNth(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  bool checked = check_short_buffers(state, [](const char* buf, size_t length, const std::vector<size_t>& matches)
+  {
+    for (size_t k = 0; k <= matches.size(); k++)
+    {
+      if (MemchrNthFunc(buf, '\n', length, k) != (k < matches.size() ? buf + matches[k] : nullptr))
+        return false;
+    }
+
+    return true;
+  });
+
+  if (checked)
+    time_short_buffers(state, [](const char* buf, size_t length) { return MemchrNthFunc(buf, '\n', length, 0); });
+}
+
+// Offsets from a non-zero base, so the wrapped offsets of a vector starting before the buffer are checked too
+template <class OffsetT, ImMemchrOffsetsFunc<OffsetT> OffsetsFunc, ImCpuFeatureFlags RequiredFeatures>
+static void BM_ShortBuffersOffsets(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  const OffsetT base = 7;
+  std::vector<OffsetT> out(state.range(0) + 1);
+
+  bool checked = check_short_buffers(state, [&](const char* buf, size_t length, const std::vector<size_t>& matches)
+  {
+    if (OffsetsFunc(buf, '\n', length, base, out.data()) != matches.size())
+      return false;
+
+    for (size_t i = 0; i < matches.size(); i++)
+    {
+      if (out[i] != OffsetT(base + matches[i]))
+        return false;
+    }
+
+    return true;
+  });
+
+  if (checked)
+    time_short_buffers(state, [&](const char* buf, size_t length) { return OffsetsFunc(buf, '\n', length, base, out.data()); });
+}
+
+static fs::path short_strings_path = fs::current_path() / "bench_config_short_strings.json";
+static benchcfg::ConfigLoader short_strings_config_loader(short_strings_path);
+
+// Strings of UI text size packed back to back, so their alignments vary. Lengths follow the
+// length_distribution of the config, capped by max_length, and match_rate of them hold a '\n'.
+class ShortStringPool
+{
+public:
+  struct Entry
+  {
+    size_t offset;
+    size_t length;
+  };
+
+  ShortStringPool(const benchcfg::BenchConfig& config, size_t max_length)
+  {
+    const size_t pool_size = (size_t)config.pool_size.get().get().value_or(4096);
+    const benchcfg::BenchConfig::LengthDistribution distribution =
+      config.length_distribution.get().get().value_or(benchcfg::BenchConfig::LengthDistribution{ 1 });
+    const double match_rate = config.match_rate.get().get().value_or(0.0);
+
+    const size_t min_length = std::min((size_t)distribution.min, max_length);
+    max_length = std::min((size_t)distribution.max.value_or(max_length), max_length);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> chars(32, 126);
+    std::uniform_int_distribution<size_t> uniform_length(min_length, max_length);
+    std::geometric_distribution<size_t> geometric_length(1.0 / std::max(distribution.mean.value_or(1.0) - min_length + 1, 1.0));
+    std::bernoulli_distribution has_match(match_rate);
+
+    entries.reserve(pool_size);
+
+    for (size_t i = 0; i < pool_size; i++)
+    {
+      size_t length = uniform_length(rng);
+
+      if (distribution.mean.has_value())
+      {
+        do
+          length = min_length + geometric_length(rng);
+        while (length > max_length);
+      }
+
+      entries.push_back({ text.size(), length });
+      total_length += length;
+
+      for (size_t k = 0; k < length; k++)
+        text.push_back((char)chars(rng));
+
+      if (length && has_match(rng))
+        text[entries.back().offset + std::uniform_int_distribution<size_t>(0, length - 1)(rng)] = '\n';
+    }
+  }
+
+  const char* data() const
+  {
+    return text.data();
+  }
+
+  std::span<const Entry> get_entries() const
+  {
+    return entries;
+  }
+
+  size_t get_total_length() const
+  {
+    return total_length;
+  }
+
+private:
+  std::string text;
+  std::vector<Entry> entries;
+  size_t total_length = 0;
+};
+
+// One call per pooled string, the varying lengths and match positions keep the branch predictor from
+// learning a single pattern. Reports the time per call next to the throughput.
+template <MemchrFuncT MemchrFunc>
+static void BM_ShortStrings(benchmark::State& state)
+{
+  if (!ImMemchrIsSupported(MemchrFunc))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  ShortStringPool pool(short_strings_config_loader.getConfig(), state.range(0));
+
+  const char* text = pool.data();
+  std::span<const ShortStringPool::Entry> entries = pool.get_entries();
+
+  for (auto _ : state)
+  {
+    for (const ShortStringPool::Entry& entry : entries)
+      benchmark::DoNotOptimize(MemchrFunc(text + entry.offset, '\n', entry.length));
+  }
+
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(entries.size()));
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(pool.get_total_length()));
+  state.counters["ns_per_call"] = benchmark::Counter(double(entries.size()) * 1e9,
+                                                     benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+// Offsets of the single match of BM_MatchLatency, read from the match_offsets of the config at registration.
+// Each slot is its own instantiation, so a benchmark knows its offset without extra arguments.
+static const size_t MAX_MATCH_OFFSETS = 16;
+static std::vector<std::optional<int64_t>> match_offsets;
+
+// A single search per iteration in a buffer without '\n' except at the offset of the slot, negative offsets
+// count from the end and an empty or out of range one leaves the buffer without a match. The calls are
+// serialized through their results, so this reports the latency of a call, which is dominated by the head and
+// the loop start up when the match is close.
+template <MemchrFuncT MemchrFunc, size_t OffsetSlot>
+static void BM_MatchLatency(benchmark::State& state)
+{
+  if (!ImMemchrIsSupported(MemchrFunc))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  size_t size = state.range(0);
+  std::optional<int64_t> offset = match_offsets[OffsetSlot];
+
+  if (offset.has_value() && offset.value() < 0)
+    offset = int64_t(size) + offset.value();
+
+  if (offset.has_value() && (offset.value() < 0 || offset.value() >= int64_t(size)))
+    offset = std::nullopt;
+
+  // The bytes before the match do not change the work of a single-byte search, a fill is much cheaper
+  // than random text at the gigabyte sizes
+  std::string data(size, 'a');
+
+  if (offset.has_value())
+    data[size_t(offset.value())] = '\n';
+
+  const char* buf = data.data();
+  const uintptr_t expected = offset.has_value() ? uintptr_t(buf + offset.value()) : 0;
+
+  if (uintptr_t(MemchrFunc(buf, '\n', size)) != expected)
+  {
+    state.SkipWithError("Result differs from the match offset");
+    return;
+  }
+
+  // Each call searches from an address computed from the result of the previous one. It always equals buf, but
+  // the loads of a call cannot start before the previous call returned, so consecutive searches do not overlap
+  // and the time per iteration is the latency of one call, not its reciprocal throughput.
+  const char* search = buf;
+
+  for (auto _ : state)
+  {
+    const void* result = MemchrFunc(search, '\n', size);
+    benchmark::DoNotOptimize(result);
+    search = (const char*)(uintptr_t(buf) + uintptr_t(result) - expected);
+  }
+
+  state.counters["match_offset"] = double(offset.value_or(-1));
+}
+
+static std::string match_offset_label(const std::optional<int64_t>& offset)
+{
+  if (!offset.has_value())
+    return "absent";
+
+  if (offset.value() == -1)
+    return "end";
+
+  if (offset.value() < 0)
+    return "end" + std::to_string(offset.value() + 1);
+
+  return std::to_string(offset.value());
+}
+
+template <MemchrFuncT MemchrFunc, size_t... OffsetSlots>
+static void register_match_latency(benchcfg::ConfigLoader& loader, const char* name, std::index_sequence<OffsetSlots...>)
+{
+  ((OffsetSlots < match_offsets.size()
+     ? (void)::benchmark::internal::RegisterBenchmarkInternal(
+         benchcfg::from_config(
+           benchcfg::setConfigName(loader.getConfig(),
+                                   std::string(name) + "/offset:" + match_offset_label(match_offsets[OffsetSlots]),
+                                   BM_MatchLatency<MemchrFunc, OffsetSlots>)))
+     : (void)0), ...);
+}
+
+static int register_match_latencies(benchcfg::ConfigLoader& loader)
+{
+  static const std::vector<std::optional<int64_t>> default_offsets = { 0, 15, 31, 63, 255, 4096, -1, std::nullopt };
+
+  match_offsets = loader.getConfig().match_offsets.get().get().value_or(default_offsets);
+
+  if (match_offsets.size() > MAX_MATCH_OFFSETS)
+  {
+    fmt::println("Warning: only the first {} of {} match_offsets are benchmarked", MAX_MATCH_OFFSETS, match_offsets.size());
+    match_offsets.resize(MAX_MATCH_OFFSETS);
+  }
+
+  using OffsetSlots = std::make_index_sequence<MAX_MATCH_OFFSETS>;
+
+  register_match_latency<ImMemchr>(loader, "ImMemchrLatency_DISPATCH", OffsetSlots{});
+  register_match_latency<ImMemchrAVX512_MASKED_UNROLL4>(loader, "ImMemchrLatency_AVX512_MASKED_UNROLL4", OffsetSlots{});
+  register_match_latency<ImMemchrAVX512_MASKED>(loader, "ImMemchrLatency_AVX512_MASKED", OffsetSlots{});
+  register_match_latency<ImMemchrAVX512>(loader, "ImMemchrLatency_AVX512", OffsetSlots{});
+  register_match_latency<ImMemchrAVX2_UNROLL>(loader, "ImMemchrLatency_AVX2_UNROLL", OffsetSlots{});
+  register_match_latency<ImMemchrAVX2>(loader, "ImMemchrLatency_AVX2", OffsetSlots{});
+  register_match_latency<ImMemchrSSE4_2>(loader, "ImMemchrLatency_SSE4_2", OffsetSlots{});
+  register_match_latency<ImMemchrSSE_UNROLL>(loader, "ImMemchrLatency_SSE_UNROLL", OffsetSlots{});
+  register_match_latency<ImMemchrSSE>(loader, "ImMemchrLatency_SSE", OffsetSlots{});
+  register_match_latency<ImMemchrCSTD>(loader, "ImMemchrLatency_CSTD", OffsetSlots{});
+
+  return 0;
+}
+
+// Datasets of BM_CorpusLines, the built-in synthetic log first, then the corpus_files of the config.
+// As with the match offsets, each slot is its own instantiation.
+static const size_t MAX_CORPUS_DATASETS = 8;
+static const size_t SYNTHETIC_CORPUS_SIZE = 32 << 20;
+
+struct CorpusDataset
+{
+  std::string name;
+  std::unique_ptr<ImFileLineScanner> file;
+
+  // Synthetic text of this size, generated on the first get_str instead of at startup
+  size_t synthetic_size = 0;
+  std::string text;
+
+  std::string_view get_str()
+  {
+    if (!file && text.empty())
+      text = generate_log_corpus(synthetic_size);
+
+    return file ? std::string_view(file->GetData(), file->GetSize()) : std::string_view(text);
+  }
+};
+
+static std::vector<CorpusDataset> corpus_datasets;
+
+// All lines of the dataset tiled to state.range(0) bytes, built once per size and shared through the dataset
+// cache, so one pass touches as many distinct bytes as it reports. The tiled size is reported as tiled_bytes.
+template <MemchrFuncT MemchrFunc, size_t CorpusSlot>
+static void BM_CorpusLines(benchmark::State& state)
+{
+  if (!ImMemchrIsSupported(MemchrFunc))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  size_t size = state.range(0);
+
+  auto start = std::chrono::steady_clock::now();
+  std::string_view corpus = corpus_datasets[CorpusSlot].get_str();
+  std::shared_ptr<const CachedDataset> data = get_dataset_cache().get_corpus(CorpusSlot, corpus, size);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::string_view str = data->get_str();
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(all_lines<MemchrFunc>(str.data(), str.size()));
+
+  size_t lines = std::count(corpus.begin(), corpus.end(), '\n');
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(str.size()));
+  state.counters["setup_s"] = elapsed.count();
+  state.counters["tiled_bytes"] = double(str.size());
+  state.counters["avg_line"] = lines ? double(corpus.size()) / double(lines) : double(corpus.size());
+}
+
+template <MemchrFuncT MemchrFunc, size_t... CorpusSlots>
+static void register_corpus_lines(benchcfg::ConfigLoader& loader, const char* name, std::index_sequence<CorpusSlots...>)
+{
+  ((CorpusSlots < corpus_datasets.size()
+     ? (void)::benchmark::internal::RegisterBenchmarkInternal(
+         benchcfg::from_config(
+           benchcfg::setConfigName(loader.getConfig(),
+                                   std::string(name) + "/corpus:" + corpus_datasets[CorpusSlots].name,
+                                   BM_CorpusLines<MemchrFunc, CorpusSlots>)))
+     : (void)0), ...);
+}
+
+static int register_corpus_benchmarks(benchcfg::ConfigLoader& loader)
+{
+  corpus_datasets.push_back({ "synthetic_log", nullptr, SYNTHETIC_CORPUS_SIZE });
+
+  for (const std::string& file_name : loader.getConfig().corpus_files.get().get().value_or(std::vector<std::string>{}))
+  {
+    fs::path file_path = fs::current_path() / file_name;
+    // Searched many times over, not once front to back
+    ImFileLineScannerSettings settings;
+    settings.sequential = false;
+
+    auto file = std::make_unique<ImFileLineScanner>(file_path.string().c_str(), settings);
+
+    if (!file->IsOpen())
+    {
+      fmt::println("Warning: corpus file {} is missing or empty, skipped", file_path);
+      continue;
+    }
+
+    if (corpus_datasets.size() == MAX_CORPUS_DATASETS)
+    {
+      fmt::println("Warning: only {} corpus datasets are benchmarked, {} skipped", MAX_CORPUS_DATASETS, file_path);
+      continue;
+    }
+
+    corpus_datasets.push_back({ file_path.filename().string(), std::move(file) });
+  }
+
+  using CorpusSlots = std::make_index_sequence<MAX_CORPUS_DATASETS>;
+
+  register_corpus_lines<ImMemchr>(loader, "ImMemchrCorpus_DISPATCH", CorpusSlots{});
+  register_corpus_lines<ImMemchrAVX512_MASKED>(loader, "ImMemchrCorpus_AVX512_MASKED", CorpusSlots{});
+  register_corpus_lines<ImMemchrAVX512>(loader, "ImMemchrCorpus_AVX512", CorpusSlots{});
+  register_corpus_lines<ImMemchrAVX2_UNROLL>(loader, "ImMemchrCorpus_AVX2_UNROLL", CorpusSlots{});
+  register_corpus_lines<ImMemchrAVX2>(loader, "ImMemchrCorpus_AVX2", CorpusSlots{});
+  register_corpus_lines<ImMemchrSSE_UNROLL>(loader, "ImMemchrCorpus_SSE_UNROLL", CorpusSlots{});
+  register_corpus_lines<ImMemchrCSTD>(loader, "ImMemchrCorpus_CSTD", CorpusSlots{});
+
+  return 0;
+}
+
+// Synthetic log of the file benchmarks, written to dataset_dir or the working directory. The temporary directory
+// is often a tmpfs, whose pages cannot be dropped for the cold runs. The file is deleted with the object.
+class TempLogFile
+{
+public:
+  explicit TempLogFile(size_t size)
+    : path((dataset_dir.empty() ? fs::current_path() : dataset_dir) / ("immemchr_bench_" + std::to_string(size) + ".log"))
+  {
+    const std::string chunk = generate_log_corpus(std::min(size, SYNTHETIC_CORPUS_SIZE));
+
+    std::error_code error;
+    fs::create_directories(path.parent_path(), error);
+
+    {
+      std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+      for (size_t written = 0; written < size && file; written += chunk.size())
+        file.write(chunk.data(), std::min(chunk.size(), size - written));
+
+      file.close();
+
+      if (!file)
+      {
+        fs::remove(path, error);
+        return;
+      }
+    }
+
+    write_ok = true;
+
+    // Written back to disk, otherwise the dirty pages cannot be dropped from the cache for the cold runs
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+      FlushFileBuffers(file);
+      CloseHandle(file);
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+      fsync(fd);
+      close(fd);
+    }
+#endif
+  }
+
+  ~TempLogFile()
+  {
+    std::error_code error;
+    fs::remove(path, error);
+  }
+
+  const fs::path& get_path() const
+  {
+    return path;
+  }
+
+  bool is_written() const
+  {
+    return write_ok;
+  }
+
+private:
+  fs::path path;
+  bool write_ok = false;
+};
+
+// One file on disk at a time: the warm and cold runs of a size share it, and it is deleted as soon as a
+// benchmark asks for another size, so a sweep never keeps every size on disk
+static const TempLogFile& get_temp_log_file(size_t size)
+{
+  static std::unique_ptr<TempLogFile> file;
+  static size_t file_size = 0;
+
+  if (!file || file_size != size)
+  {
+    file.reset();
+    file = std::make_unique<TempLogFile>(size);
+    file_size = size;
+  }
+
+  return *file;
+}
+
+static void drop_file_cache(const fs::path& path)
+{
+#if defined(_WIN32)
+  // Opening a file without buffering purges its cached pages when no other handle is open
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+  if (file != INVALID_HANDLE_VALUE)
+    CloseHandle(file);
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+#endif
+}
+
+// Buffered reads into a reused buffer, each chunk searched by the same all-matches kernel as the scanner.
+// Interrupted reads are retried, nothing is returned when the file cannot be opened or read.
+static std::optional<size_t> count_lines_read(const fs::path& path, std::vector<char>& buffer)
+{
+  size_t lines = 0;
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return std::nullopt;
+
+  DWORD read_size = 0;
+  BOOL read_ok = FALSE;
+
+  while ((read_ok = ReadFile(file, buffer.data(), (DWORD)buffer.size(), &read_size, nullptr)) && read_size > 0)
+    lines += ImMemchrAll(buffer.data(), '\n', read_size, [](size_t) {});
+
+  CloseHandle(file);
+
+  if (!read_ok)
+    return std::nullopt;
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return std::nullopt;
+
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  ssize_t read_size = 0;
+
+  for (;;)
+  {
+    do
+      read_size = read(fd, buffer.data(), buffer.size());
+    while (read_size < 0 && errno == EINTR);
+
+    if (read_size <= 0)
+      break;
+
+    lines += ImMemchrAll(buffer.data(), '\n', (size_t)read_size, [](size_t) {});
+  }
+
+  close(fd);
+
+  if (read_size < 0)
+    return std::nullopt;
+#endif
+
+  return lines;
+}
+
+// Arguments: file size and page cache state, 0 for warm and 1 for cold. Cold runs drop the file from
+// the page cache before every iteration, outside of the timing.
+template <unsigned int ReadAheadThreads, bool HugePages>
+static void BM_FileLinesMapped(benchmark::State& state)
+{
+  size_t size = state.range(0);
+  bool cold = state.range(1) != 0;
+
+  const TempLogFile& file = get_temp_log_file(size);
+
+  if (!file.is_written())
+  {
+    state.SkipWithError("Writing the log file failed");
+    return;
+  }
+
+  const fs::path& path = file.get_path();
+  const std::string path_string = path.string();
+
+  ImFileLineScannerSettings settings;
+  settings.read_ahead_threads = ReadAheadThreads;
+  settings.huge_pages = HugePages;
+
+  size_t lines = 0;
+
+  for (auto _ : state)
+  {
+    if (cold)
+    {
+      state.PauseTiming();
+      drop_file_cache(path);
+      state.ResumeTiming();
+    }
+
+    ImFileLineScanner scanner(path_string.c_str(), settings);
+
+    if (!scanner.IsOpen())
+    {
+      state.SkipWithError("Mapping the log file failed");
+      break;
+    }
+
+    lines = scanner.CountLines();
+    benchmark::DoNotOptimize(lines);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  state.counters["lines"] = double(lines);
+}
+
+template <size_t BufferLength>
+static void BM_FileLinesRead(benchmark::State& state)
+{
+  size_t size = state.range(0);
+  bool cold = state.range(1) != 0;
+
+  const TempLogFile& file = get_temp_log_file(size);
+
+  if (!file.is_written())
+  {
+    state.SkipWithError("Writing the log file failed");
+    return;
+  }
+
+  const fs::path& path = file.get_path();
+  std::vector<char> buffer(BufferLength);
+
+  size_t lines = 0;
+
+  for (auto _ : state)
+  {
+    if (cold)
+    {
+      state.PauseTiming();
+      drop_file_cache(path);
+      state.ResumeTiming();
+    }
+
+    std::optional<size_t> result = count_lines_read(path, buffer);
+
+    if (!result.has_value())
+    {
+      state.SkipWithError("Reading the log file failed");
+      break;
+    }
+
+    lines = result.value();
+    benchmark::DoNotOptimize(lines);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  state.counters["lines"] = double(lines);
+}
+
+static const size_t PIPE_BUFFER_SIZE = 1 << 20;
+
+// Pushes the text through a local pipe from a writer thread while the splitter reads the other end.
+// Returns the number of lines, nothing when the pipe cannot be created or reading it fails.
+static std::optional<size_t> split_through_pipe(std::string_view text, ImLineStreamSplitter& splitter)
+{
+  ImLineStreamFileReader reader;
+
+#if defined(_WIN32)
+  HANDLE read_end = nullptr;
+  HANDLE write_end = nullptr;
+
+  if (!CreatePipe(&read_end, &write_end, nullptr, (DWORD)PIPE_BUFFER_SIZE))
+    return std::nullopt;
+
+  std::thread writer([&]
+  {
+    for (size_t offset = 0; offset < text.size(); )
+    {
+      DWORD written = 0;
+      if (!WriteFile(write_end, text.data() + offset, (DWORD)std::min(text.size() - offset, PIPE_BUFFER_SIZE), &written, nullptr))
+        break;
+
+      offset += written;
+    }
+
+    CloseHandle(write_end);
+  });
+
+  reader.file = read_end;
+#else
+  int fds[2];
+
+  if (pipe(fds) != 0)
+    return std::nullopt;
+
+#if defined(F_SETPIPE_SZ)
+  fcntl(fds[1], F_SETPIPE_SZ, (int)PIPE_BUFFER_SIZE);
+#endif
+
+  std::thread writer([&]
+  {
+    for (size_t offset = 0; offset < text.size(); )
+    {
+      ssize_t written = write(fds[1], text.data() + offset, std::min(text.size() - offset, PIPE_BUFFER_SIZE));
+      if (written < 0 && errno == EINTR)
+        continue;
+      if (written <= 0)
+        break;
+
+      offset += (size_t)written;
+    }
+
+    close(fds[1]);
+  });
+
+  reader.fd = fds[0];
+#endif
+
+  size_t lines = splitter.CountLines(reader);
+  writer.join();
+
+#if defined(_WIN32)
+  CloseHandle(read_end);
+#else
+  close(fds[0]);
+#endif
+
+  if (splitter.HasReadError())
+    return std::nullopt;
+
+  return lines;
+}
+
+// Arguments: buffer size and chunk length of the splitter. Chunks are filled before they are scanned, so the
+// chunk length sets the scan granularity whatever the pipe returns per read.
+static void BM_StreamLines(benchmark::State& state)
+{
+  size_t size = state.range(0);
+  size_t chunk_length = state.range(1);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, 0, 131);
+  std::string_view str = data->get_str();
+
+  ImLineStreamSettings settings;
+  settings.chunk_length = chunk_length;
+  settings.carry_length = chunk_length;
+  settings.fill_chunks = true;
+
+  ImLineStreamSplitter splitter(settings);
+  size_t lines = 0;
+
+  for (auto _ : state)
+  {
+    std::optional<size_t> result = split_through_pipe(str, splitter);
+
+    if (!result.has_value())
+    {
+      state.SkipWithError("Reading the pipe failed");
+      break;
+    }
+
+    lines = result.value();
+    benchmark::DoNotOptimize(lines);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+  state.counters["lines"] = double(lines);
+}
+
+// Every ImMemchrKernel instantiation benchmarked by BM_AllLines: each ISA, unrolled 1 to 8 times, with and without prefetch
+template <class... Isas>
+struct MemchrKernelIsaList {};
+
+using MemchrKernelIsas = MemchrKernelIsaList<ImSimdAVX512, ImSimdAVX2, ImSimdSSE4_2, ImSimdSSE2>;
+using MemchrKernelUnrolls = std::integer_sequence<int, 1, 2, 3, 4, 5, 6, 7, 8>;
+
+template <class Isa, class PrefetchPolicy, int... Unrolls>
+static void register_all_lines_kernel(benchcfg::ConfigLoader& loader, std::integer_sequence<int, Unrolls...>)
+{
+  (::benchmark::internal::RegisterBenchmarkInternal(
+     benchcfg::from_config(
+       benchcfg::setConfigName(loader.getConfig(),
+                               std::string("ImMemchr_") + Isa::NAME + "_U" + std::to_string(Unrolls) + PrefetchPolicy::SUFFIX,
+                               BM_AllLinesKernel<Isa, Unrolls, PrefetchPolicy>))), ...);
+}
+
+template <class... Isas>
+static int register_all_lines_kernels(benchcfg::ConfigLoader& loader, MemchrKernelIsaList<Isas...>)
+{
+  ((register_all_lines_kernel<Isas, ImPrefetchTuned>(loader, MemchrKernelUnrolls{}),
+    register_all_lines_kernel<Isas, ImPrefetchNone>(loader, MemchrKernelUnrolls{})), ...);
+
+  return 0;
+}
+
+template <MemchrAllFuncT<AllMatchesSink&> MemchrAllFunc, ImCpuFeatureFlags RequiredFeatures>
+static void BM_AllMatches(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  size_t size = state.range(0);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, 0, 131);
+
+  std::string_view strv = data->get_str();
+  const char* buf = strv.data();
+  size_t buf_size = strv.size();
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(all_matches<MemchrAllFunc>(buf, buf_size));
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+}
+
+template <MemcountFuncT MemcountFunc, ImCpuFeatureFlags RequiredFeatures, size_t LineSize>
+static void BM_Memcount(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  size_t size = state.range(0);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, 0, LineSize);
+
+  std::string_view strv = data->get_str();
+  const char* buf = strv.data();
+  size_t buf_size = strv.size();
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(MemcountFunc(buf, '\n', buf_size));
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+}
+
+template <MemchrNthFuncT MemchrNthFunc, ImCpuFeatureFlags RequiredFeatures, size_t LineSize>
+static void BM_MemchrNth(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  size_t size = state.range(0);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, 0, LineSize);
+
+  std::string_view strv = data->get_str();
+  const char* buf = strv.data();
+  size_t buf_size = strv.size();
+
+  // Jump to the last line, so every kernel scans the whole buffer
+  size_t last_line = (buf_size + LineSize - 1) / LineSize - 1;
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(MemchrNthFunc(buf, '\n', buf_size, last_line));
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+}
+
+static void BM_LineIndex_PushBack(benchmark::State& state)
+{
+  size_t size = state.range(0);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, 0, 131);
+
+  std::string_view strv = data->get_str();
+  const char* buf = strv.data();
+  size_t buf_size = strv.size();
+
+  std::vector<size_t> line_starts;
+
+  for (auto _ : state)
+  {
+    line_starts.clear();
+    line_starts.push_back(0);
+
+    const char* ptr = buf;
+    const char* end = buf + buf_size;
+
+    while (const char* new_line = (const char*)ImMemchr(ptr, '\n', end - ptr))
+    {
+      ptr = new_line + 1;
+      line_starts.push_back(ptr - buf);
+    }
+
+    benchmark::DoNotOptimize(line_starts.data());
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+  state.counters["index_bytes"] = double(line_starts.capacity() * sizeof(size_t));
+}
+
+template <class OffsetT, ImMemchrOffsetsFunc<OffsetT> OffsetsFunc, ImCpuFeatureFlags RequiredFeatures>
+static void BM_LineIndex(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  size_t size = state.range(0);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, 0, 131);
+
+  std::string_view strv = data->get_str();
+  const char* buf = strv.data();
+  size_t buf_size = strv.size();
+
+  ImLineIndexT<OffsetT> index;
+
+  for (auto _ : state)
+  {
+    index.Build(buf, buf_size, OffsetsFunc);
+    benchmark::DoNotOptimize(index.GetLineCount());
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+  state.counters["index_bytes"] = double(index.GetMemoryUsage());
+}
+
+enum class MatchPosition
+{
+  Early,
+  Middle,
+  None
+};
+
+template <MatchPosition Position, unsigned int ThreadCount>
+static void BM_MemchrParallel(benchmark::State& state)
+{
+  size_t size = state.range(0);
+
+  // Random ASCII has no newlines without line_size, the single needle is placed explicitly
+  TestData data(size);
+
+  if constexpr (Position == MatchPosition::Early)
+    data.set_char(size / 64, '\n');
+  else if constexpr (Position == MatchPosition::Middle)
+    data.set_char(size / 2, '\n');
+
+  std::string_view strv = data.get_str();
+  const char* buf = strv.data();
+  size_t buf_size = strv.size();
+
+  ImThreadPool pool(ThreadCount);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(ImMemchrParallel(buf, '\n', buf_size, pool));
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+  state.counters["threads"] = ThreadCount;
+}
+
+// The *_Threads benchmarks run ImMemcountParallel and ImLineIndexT::BuildParallel on one benchmark thread, with
+// a pool of state.range(1) threads from the config threads or thread_range, see register_pool_benchmark
+static void BM_MemcountThreads(benchmark::State& state)
+{
+  size_t size = state.range(0);
+  unsigned int pool_size = (unsigned int)state.range(1);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, 0, 131);
+  std::string_view strv = data->get_str();
+
+  ImThreadPool pool(pool_size);
+  size_t count = 0;
+
+  for (auto _ : state)
+  {
+    count = ImMemcountParallel(strv.data(), '\n', strv.size(), pool);
+    benchmark::DoNotOptimize(count);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+  state.counters["threads"] = pool_size;
+  state.counters["matches"] = double(count);
+}
+
+template <class OffsetT>
+static void BM_LineIndexThreads(benchmark::State& state)
+{
+  size_t size = state.range(0);
+  unsigned int pool_size = (unsigned int)state.range(1);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, 0, 131);
+  std::string_view strv = data->get_str();
+
+  ImThreadPool pool(pool_size);
+  ImLineIndexT<OffsetT> index;
+
+  for (auto _ : state)
+  {
+    index.BuildParallel(strv.data(), strv.size(), pool);
+    benchmark::DoNotOptimize(index.GetLineCount());
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+  state.counters["threads"] = pool_size;
+  state.counters["lines"] = double(index.GetLineCount());
+}
+
+// Registers a pool benchmark from a config with threads or thread_range: its thread counts become the pool
+// argument next to the buffer size, the same counts ThreadRange would run, and the benchmark runs on one thread
+static void register_pool_benchmark(benchcfg::ConfigLoader& loader, const char* name, benchmark::internal::Function* function)
+{
+  benchcfg::BenchConfig config = loader.getConfig();
+  std::vector<int64_t> pool_sizes;
+
+  if (const std::optional<int>& threads = config.threads.get().get(); threads.has_value())
+    pool_sizes.push_back(threads.value());
+
+  if (const std::optional<benchcfg::BenchConfig::ThreadRange>& range = config.thread_range.get().get(); range.has_value())
+  {
+    const int max_threads = std::max(1, range->max_threads);
+    const int stride = std::max(1, range->stride.value_or(1));
+
+    for (int count = std::max(1, range->min_threads); count < max_threads; count = range->stride.has_value() ? count + stride : count * 2)
+      pool_sizes.push_back(count);
+
+    pool_sizes.push_back(max_threads);
+  }
+
+  if (pool_sizes.empty())
+    pool_sizes.push_back(std::max(1u, std::thread::hardware_concurrency()));
+
+  std::vector<benchcfg::BenchConfig::Arg> args(2);
+  args[0].name = "size";
+  args[0].range = config.value_range.get().get();
+  args[1].name = "pool";
+  args[1].values = pool_sizes;
+
+  config.args.set(args);
+  config.threads.set(std::nullopt);
+  config.thread_range.set(std::nullopt);
+
+  ::benchmark::internal::RegisterBenchmarkInternal(benchcfg::from_config(benchcfg::setConfigName(config, name, function)));
+}
+
+static int register_pool_benchmarks(benchcfg::ConfigLoader& loader)
+{
+  register_pool_benchmark(loader, "ImMemcount_Threads", BM_MemcountThreads);
+  register_pool_benchmark(loader, "ImLineIndex_Threads", BM_LineIndexThreads<uint32_t>);
+  register_pool_benchmark(loader, "ImLineIndex64_Threads", BM_LineIndexThreads<uint64_t>);
+
+  return 0;
+}
+
+// Searchers are built once per benchmark from the needle and return the first match in [first, last) or nullptr
+template <ImMemmemFunc MemmemFunc>
+struct MemmemSearcher
+{
+  std::string_view needle;
+
+  const char* operator()(const char* first, const char* last) const
+  {
+    return (const char*)MemmemFunc(first, last - first, needle.data(), needle.size());
+  }
+};
+
+struct StringViewSearcher
+{
+  std::string_view needle;
+
+  const char* operator()(const char* first, const char* last) const
+  {
+    std::string_view haystack(first, last - first);
+    size_t pos = haystack.find(needle);
+
+    return pos != std::string_view::npos ? first + pos : nullptr;
+  }
+};
+
+struct HorspoolSearcher
+{
+  std::boyer_moore_horspool_searcher<std::string_view::const_iterator> searcher;
+
+  HorspoolSearcher(std::string_view needle)
+    : searcher(needle.begin(), needle.end())
+  {
+  }
+
+  const char* operator()(const char* first, const char* last) const
+  {
+    std::string_view haystack(first, last - first);
+    auto it = std::search(haystack.begin(), haystack.end(), searcher);
+
+    return it != haystack.end() ? first + (it - haystack.begin()) : nullptr;
+  }
+};
+
+// Log-like needle, cut to NeedleLength. Period 0 plants a single needle at the end of the buffer,
+// otherwise one every Period bytes. The random ASCII already matches the first byte every ~95 bytes.
+template <class Searcher, ImCpuFeatureFlags RequiredFeatures, size_t NeedleLength, size_t Period>
+static void BM_Memmem(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  static constexpr std::string_view pattern = "ERROR: connection reset by peer while reading the response body";
+  static_assert(NeedleLength <= pattern.size());
+  const std::string_view needle = pattern.substr(0, NeedleLength);
+
+  size_t size = state.range(0);
+
+  TestData data(size);
+
+  auto plant = [&](size_t pos)
+  {
+    for (size_t i = 0; i < needle.size(); i++)
+      data.set_char(pos + i, needle[i]);
+  };
+
+  if constexpr (Period == 0)
+    plant(size - NeedleLength);
+  else
+  {
+    for (size_t pos = 0; pos + NeedleLength <= size; pos += Period)
+      plant(pos);
+  }
+
+  std::string_view strv = data.get_str();
+  const char* buf = strv.data();
+  const char* end = buf + strv.size();
+
+  const Searcher searcher{ needle };
+  size_t matches = 0;
+
+  for (auto _ : state)
+  {
+    matches = 0;
+
+    for (const char* ptr = buf; (ptr = searcher(ptr, end)) != nullptr; ptr++)
+      matches++;
+
+    benchmark::DoNotOptimize(matches);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+  state.counters["matches"] = double(matches);
+}
+
+template <ImMemchrSetFunc MemchrSetFunc>
+struct ByteSetSearcher
+{
+  ImByteSet set;
+
+  ByteSetSearcher(std::string_view bytes)
+    : set(bytes.data(), bytes.size())
+  {
+  }
+
+  const char* operator()(const char* first, const char* last) const
+  {
+    return (const char*)MemchrSetFunc(first, last - first, set);
+  }
+};
+
+// One ImMemchr per set byte, each call only scans up to the nearest match so far
+struct ChainedMemchrSearcher
+{
+  std::string_view bytes;
+
+  const char* operator()(const char* first, const char* last) const
+  {
+    const char* best = nullptr;
+
+    for (char ch : bytes)
+    {
+      const char* match = (const char*)ImMemchr(first, ch, (best ? best : last) - first);
+
+      if (match)
+        best = match;
+    }
+
+    return best;
+  }
+};
+
+// strpbrk needs NUL-terminated input, TestData ends its buffer with one and the random ASCII has no NUL
+struct StrpbrkSearcher
+{
+  std::string accept;
+
+  StrpbrkSearcher(std::string_view bytes)
+    : accept(bytes)
+  {
+  }
+
+  const char* operator()(const char* first, const char*) const
+  {
+    return strpbrk(first, accept.c_str());
+  }
+};
+
+// Delimiters of our records first, then common punctuation, the first SetSize bytes form the set
+template <class Searcher, ImCpuFeatureFlags RequiredFeatures, size_t SetSize>
+static void BM_MemchrSet(benchmark::State& state)
+{
+  if (!ImHasCpuFeatures(RequiredFeatures))
+  {
+    state.SkipWithMessage("Instruction set is not supported by this CPU");
+    return;
+  }
+
+  static constexpr std::string_view delimiters = "\n\r,\"\t;|:=[]{}<>&#";
+  static_assert(SetSize <= delimiters.size());
+
+  size_t size = state.range(0);
+
+  std::shared_ptr<const CachedDataset> data = get_test_data(state, size, 0, 131);
+
+  std::string_view strv = data->get_str();
+  const char* buf = strv.data();
+  const char* end = buf + strv.size();
+
+  const Searcher searcher{ delimiters.substr(0, SetSize) };
+  size_t matches = 0;
+
+  for (auto _ : state)
+  {
+    matches = 0;
+
+    for (const char* ptr = buf; ptr < end && (ptr = searcher(ptr, end)) != nullptr; ptr++)
+      matches++;
+
+    benchmark::DoNotOptimize(matches);
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size));
+  report_peak_rss(state);
+  state.counters["matches"] = double(matches);
+}
+
+auto BM_AllLines_DISPATCH               = BM_AllLines<ImMemchr>;
+
+auto BM_AllLines_AVX512_MASKED_UNROLL4_PREFETCH = BM_AllLines<ImMemchrAVX512_MASKED_UNROLL4_PREFETCH>;
+auto BM_AllLines_AVX512_MASKED_UNROLL4          = BM_AllLines<ImMemchrAVX512_MASKED_UNROLL4>;
+auto BM_AllLines_AVX512_MASKED_UNROLL2_PREFETCH = BM_AllLines<ImMemchrAVX512_MASKED_UNROLL2_PREFETCH>;
+auto BM_AllLines_AVX512_MASKED_UNROLL2          = BM_AllLines<ImMemchrAVX512_MASKED_UNROLL2>;
+auto BM_AllLines_AVX512_MASKED_PREFETCH         = BM_AllLines<ImMemchrAVX512_MASKED_PREFETCH>;
+auto BM_AllLines_AVX512_MASKED                  = BM_AllLines<ImMemchrAVX512_MASKED>;
+
+auto BM_AllLines_CSTD                   = BM_AllLines<ImMemchrCSTD>;
+
+auto BM_ShortBuffers_DISPATCH      = BM_ShortBuffers<ImMemchr>;
+auto BM_ShortBuffers_AVX512_MASKED = BM_ShortBuffers<ImMemchrAVX512_MASKED>;
+auto BM_ShortBuffers_AVX512        = BM_ShortBuffers<ImMemchrAVX512>;
+auto BM_ShortBuffers_AVX2_UNROLL   = BM_ShortBuffers<ImMemchrAVX2_UNROLL>;
+auto BM_ShortBuffers_AVX2          = BM_ShortBuffers<ImMemchrAVX2>;
+auto BM_ShortBuffers_SSE4_2        = BM_ShortBuffers<ImMemchrSSE4_2>;
+auto BM_ShortBuffers_SSE_UNROLL    = BM_ShortBuffers<ImMemchrSSE_UNROLL>;
+auto BM_ShortBuffers_SSE           = BM_ShortBuffers<ImMemchrSSE>;
+auto BM_ShortBuffers_CSTD          = BM_ShortBuffers<ImMemchrCSTD>;
+
+auto BM_ShortBuffersAll_DISPATCH    = BM_ShortBuffersAll<ImMemchrAll<ShortBufferMatches&>, ImCpuFeatureFlags_None>;
+auto BM_ShortBuffersAll_AVX512      = BM_ShortBuffersAll<ImMemchrAllAVX512<ShortBufferMatches&>, ImMemchrRequiredAVX512>;
+auto BM_ShortBuffersAll_AVX2        = BM_ShortBuffersAll<ImMemchrAllAVX2<ShortBufferMatches&>, ImMemchrRequiredAVX2>;
+auto BM_ShortBuffersAll_SSE         = BM_ShortBuffersAll<ImMemchrAllSSE<ShortBufferMatches&>, ImMemchrRequiredSSE2>;
+auto BM_ShortBuffersAll_CSTD        = BM_ShortBuffersAll<ImMemchrAllCSTD<ShortBufferMatches&>, ImCpuFeatureFlags_None>;
+
+auto BM_ShortBuffersOffsets_AVX512_VBMI2   = BM_ShortBuffersOffsets<uint32_t, ImMemchrOffsetsAVX512_VBMI2<uint32_t>, ImMemchrRequiredAVX512_VBMI2>;
+auto BM_ShortBuffersOffsets64_AVX512_VBMI2 = BM_ShortBuffersOffsets<uint64_t, ImMemchrOffsetsAVX512_VBMI2<uint64_t>, ImMemchrRequiredAVX512_VBMI2>;
+auto BM_ShortBuffersOffsets_AVX512         = BM_ShortBuffersOffsets<uint32_t, ImMemchrOffsetsAVX512<uint32_t>, ImMemchrRequiredAVX512>;
+auto BM_ShortBuffersOffsets_AVX2           = BM_ShortBuffersOffsets<uint32_t, ImMemchrOffsetsAVX2<uint32_t>, ImMemchrRequiredAVX2>;
+auto BM_ShortBuffersOffsets_SSE            = BM_ShortBuffersOffsets<uint32_t, ImMemchrOffsetsSSE<uint32_t>, ImMemchrRequiredSSE2>;
+auto BM_ShortBuffersOffsets_CSTD           = BM_ShortBuffersOffsets<uint32_t, ImMemchrOffsetsCSTD<uint32_t>, ImCpuFeatureFlags_None>;
+
+auto BM_ShortStrings_DISPATCH      = BM_ShortStrings<ImMemchr>;
+auto BM_ShortStrings_AVX512_MASKED = BM_ShortStrings<ImMemchrAVX512_MASKED>;
+auto BM_ShortStrings_AVX512        = BM_ShortStrings<ImMemchrAVX512>;
+auto BM_ShortStrings_AVX2_UNROLL   = BM_ShortStrings<ImMemchrAVX2_UNROLL>;
+auto BM_ShortStrings_AVX2          = BM_ShortStrings<ImMemchrAVX2>;
+auto BM_ShortStrings_SSE4_2        = BM_ShortStrings<ImMemchrSSE4_2>;
+auto BM_ShortStrings_SSE_UNROLL    = BM_ShortStrings<ImMemchrSSE_UNROLL>;
+auto BM_ShortStrings_SSE           = BM_ShortStrings<ImMemchrSSE>;
+auto BM_ShortStrings_CSTD          = BM_ShortStrings<ImMemchrCSTD>;
+
+auto BM_FileLines_Mapped           = BM_FileLinesMapped<0, false>;
+auto BM_FileLines_Mapped_HugePages = BM_FileLinesMapped<0, true>;
+auto BM_FileLines_Mapped_ReadAhead = BM_FileLinesMapped<2, false>;
+auto BM_FileLines_Read             = BM_FileLinesRead<1024 * 1024>;
+
+auto BM_AllMatches_AVX512               = BM_AllMatches<ImMemchrAllAVX512<AllMatchesSink&>, ImMemchrRequiredAVX512>;
+auto BM_AllMatches_AVX2                 = BM_AllMatches<ImMemchrAllAVX2<AllMatchesSink&>, ImMemchrRequiredAVX2>;
+auto BM_AllMatches_SSE                  = BM_AllMatches<ImMemchrAllSSE<AllMatchesSink&>, ImMemchrRequiredSSE2>;
+auto BM_AllMatches_CSTD                 = BM_AllMatches<ImMemchrAllCSTD<AllMatchesSink&>, ImCpuFeatureFlags_None>;
+
+auto BM_LineIndex_AVX512_VBMI2           = BM_LineIndex<uint32_t, ImMemchrOffsetsAVX512_VBMI2<uint32_t>, ImMemchrRequiredAVX512_VBMI2>;
+auto BM_LineIndex64_AVX512_VBMI2         = BM_LineIndex<uint64_t, ImMemchrOffsetsAVX512_VBMI2<uint64_t>, ImMemchrRequiredAVX512_VBMI2>;
+auto BM_LineIndex_AVX512                 = BM_LineIndex<uint32_t, ImMemchrOffsetsAVX512<uint32_t>, ImMemchrRequiredAVX512>;
+auto BM_LineIndex64_AVX512               = BM_LineIndex<uint64_t, ImMemchrOffsetsAVX512<uint64_t>, ImMemchrRequiredAVX512>;
+auto BM_LineIndex_AVX2                   = BM_LineIndex<uint32_t, ImMemchrOffsetsAVX2<uint32_t>, ImMemchrRequiredAVX2>;
+auto BM_LineIndex64_AVX2                 = BM_LineIndex<uint64_t, ImMemchrOffsetsAVX2<uint64_t>, ImMemchrRequiredAVX2>;
+
+#define BENCHMARK_LINE_SIZES(BM, FUNCTION, REQUIRED, NAME)                                     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM<FUNCTION, REQUIRED, 16>), NAME "/line:16")     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM<FUNCTION, REQUIRED, 131>), NAME "/line:131")   \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM<FUNCTION, REQUIRED, 1024>), NAME "/line:1024")
+
+#define BENCHMARK_PARALLEL_THREADS(CONFIG_LOADER, POSITION, NAME)                                                                   \
+  BENCHMARK_FROM_CONFIG_LOADER(CONFIG_LOADER, (BM_MemchrParallel<MatchPosition::POSITION, 1>), NAME "_" #POSITION "/threads:1")   \
+  BENCHMARK_FROM_CONFIG_LOADER(CONFIG_LOADER, (BM_MemchrParallel<MatchPosition::POSITION, 2>), NAME "_" #POSITION "/threads:2")   \
+  BENCHMARK_FROM_CONFIG_LOADER(CONFIG_LOADER, (BM_MemchrParallel<MatchPosition::POSITION, 4>), NAME "_" #POSITION "/threads:4")   \
+  BENCHMARK_FROM_CONFIG_LOADER(CONFIG_LOADER, (BM_MemchrParallel<MatchPosition::POSITION, 8>), NAME "_" #POSITION "/threads:8")   \
+  BENCHMARK_FROM_CONFIG_LOADER(CONFIG_LOADER, (BM_MemchrParallel<MatchPosition::POSITION, 16>), NAME "_" #POSITION "/threads:16")
+
+#define BENCHMARK_NEEDLES(SEARCHER, REQUIRED, NAME)                                                                 \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_Memmem<SEARCHER, REQUIRED, 2, 0>), NAME "/needle:2/every:none")     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_Memmem<SEARCHER, REQUIRED, 8, 0>), NAME "/needle:8/every:none")     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_Memmem<SEARCHER, REQUIRED, 32, 0>), NAME "/needle:32/every:none")   \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_Memmem<SEARCHER, REQUIRED, 2, 256>), NAME "/needle:2/every:256")    \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_Memmem<SEARCHER, REQUIRED, 8, 256>), NAME "/needle:8/every:256")    \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_Memmem<SEARCHER, REQUIRED, 32, 256>), NAME "/needle:32/every:256")
+
+#define BENCHMARK_SET_SIZES(SEARCHER, REQUIRED, NAME)                                                  \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_MemchrSet<SEARCHER, REQUIRED, 1>), NAME "/set:1")     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_MemchrSet<SEARCHER, REQUIRED, 2>), NAME "/set:2")     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_MemchrSet<SEARCHER, REQUIRED, 3>), NAME "/set:3")     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_MemchrSet<SEARCHER, REQUIRED, 4>), NAME "/set:4")     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_MemchrSet<SEARCHER, REQUIRED, 5>), NAME "/set:5")     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_MemchrSet<SEARCHER, REQUIRED, 8>), NAME "/set:8")     \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_MemchrSet<SEARCHER, REQUIRED, 12>), NAME "/set:12")   \
+  BENCHMARK_FROM_CONFIG_LOADER(config_loader, (BM_MemchrSet<SEARCHER, REQUIRED, 16>), NAME "/set:16")
+
+static fs::path path = fs::current_path() / "bench_config.json";
+static benchcfg::ConfigLoader config_loader(path);
+
+static fs::path lines_path = fs::current_path() / "bench_config_lines.json";
+static benchcfg::ConfigLoader lines_config_loader(lines_path);
+
+static fs::path parallel_path = fs::current_path() / "bench_config_parallel.json";
+static benchcfg::ConfigLoader parallel_config_loader(parallel_path);
+
+static fs::path threads_path = fs::current_path() / "bench_config_threads.json";
+static benchcfg::ConfigLoader threads_config_loader(threads_path);
+
+static fs::path files_path = fs::current_path() / "bench_config_files.json";
+static benchcfg::ConfigLoader files_config_loader(files_path);
+
+static fs::path stream_path = fs::current_path() / "bench_config_stream.json";
+static benchcfg::ConfigLoader stream_config_loader(stream_path);
+
+static fs::path short_buffers_path = fs::current_path() / "bench_config_short_buffers.json";
+static benchcfg::ConfigLoader short_buffers_config_loader(short_buffers_path);
+
+BENCHMARK_FROM_CONFIG_LOADER(lines_config_loader, BM_AllLines_DISPATCH, "ImMemchr_DISPATCH")
+
+static const int all_lines_kernels_registered = register_all_lines_kernels(lines_config_loader, MemchrKernelIsas{});
+
+BENCHMARK_FROM_CONFIG_LOADER(lines_config_loader, BM_AllLines_AVX512_MASKED_UNROLL4_PREFETCH, "ImMemchr_AVX512_MASKED_UNROLL4_PREFETCH")
+BENCHMARK_FROM_CONFIG_LOADER(lines_config_loader, BM_AllLines_AVX512_MASKED_UNROLL4, "ImMemchr_AVX512_MASKED_UNROLL4")
+BENCHMARK_FROM_CONFIG_LOADER(lines_config_loader, BM_AllLines_AVX512_MASKED_UNROLL2_PREFETCH, "ImMemchr_AVX512_MASKED_UNROLL2_PREFETCH")
+BENCHMARK_FROM_CONFIG_LOADER(lines_config_loader, BM_AllLines_AVX512_MASKED_UNROLL2, "ImMemchr_AVX512_MASKED_UNROLL2")
+BENCHMARK_FROM_CONFIG_LOADER(lines_config_loader, BM_AllLines_AVX512_MASKED_PREFETCH, "ImMemchr_AVX512_MASKED_PREFETCH")
+BENCHMARK_FROM_CONFIG_LOADER(lines_config_loader, BM_AllLines_AVX512_MASKED, "ImMemchr_AVX512_MASKED")
+
+BENCHMARK_FROM_CONFIG_LOADER(lines_config_loader, BM_AllLines_CSTD, "ImMemchr_CSTD")
+
+static const int match_latencies_registered = register_match_latencies(config_loader);
+
+static const int corpus_benchmarks_registered = register_corpus_benchmarks(config_loader);
+
+BENCHMARK_FROM_CONFIG_LOADER(files_config_loader, BM_FileLines_Mapped, "ImFileLines_Mapped")
+BENCHMARK_FROM_CONFIG_LOADER(files_config_loader, BM_FileLines_Mapped_HugePages, "ImFileLines_Mapped_HugePages")
+BENCHMARK_FROM_CONFIG_LOADER(files_config_loader, BM_FileLines_Mapped_ReadAhead, "ImFileLines_Mapped_ReadAhead2")
+BENCHMARK_FROM_CONFIG_LOADER(files_config_loader, BM_FileLines_Read, "ImFileLines_Read")
+
+BENCHMARK_FROM_CONFIG_LOADER(stream_config_loader, BM_StreamLines, "ImStreamLines_Pipe")
+
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffers_DISPATCH, "ImMemchrShort_DISPATCH")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffers_AVX512_MASKED, "ImMemchrShort_AVX512_MASKED")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffers_AVX512, "ImMemchrShort_AVX512")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffers_AVX2_UNROLL, "ImMemchrShort_AVX2_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffers_AVX2, "ImMemchrShort_AVX2")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffers_SSE4_2, "ImMemchrShort_SSE4_2")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffers_SSE_UNROLL, "ImMemchrShort_SSE_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffers_SSE, "ImMemchrShort_SSE")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffers_CSTD, "ImMemchrShort_CSTD")
+
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersAll_DISPATCH, "ImMemchrAllShort_DISPATCH")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersAll_AVX512, "ImMemchrAllShort_AVX512")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersAll_AVX2, "ImMemchrAllShort_AVX2")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersAll_SSE, "ImMemchrAllShort_SSE")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersAll_CSTD, "ImMemchrAllShort_CSTD")
+
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersCount<ImMemcount, ImCpuFeatureFlags_None>), "ImMemcountShort_DISPATCH")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersCount<ImMemcountAVX512, ImMemchrRequiredAVX512>), "ImMemcountShort_AVX512")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersCount<ImMemcountAVX2_UNROLL, ImMemchrRequiredAVX2>), "ImMemcountShort_AVX2_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersCount<ImMemcountAVX2, ImMemchrRequiredAVX2>), "ImMemcountShort_AVX2")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersCount<ImMemcountSSE4_2_UNROLL, ImMemchrRequiredSSE4_2>), "ImMemcountShort_SSE4_2_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersCount<ImMemcountSSE4_2, ImMemchrRequiredSSE4_2>), "ImMemcountShort_SSE4_2")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersCount<ImMemcountSSE_UNROLL, ImMemchrRequiredSSE2>), "ImMemcountShort_SSE_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersCount<ImMemcountSSE, ImMemchrRequiredSSE2>), "ImMemcountShort_SSE")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersCount<ImMemcountCSTD, ImCpuFeatureFlags_None>), "ImMemcountShort_CSTD")
+
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersNth<ImMemchrNth, ImCpuFeatureFlags_None>), "ImMemchrNthShort_DISPATCH")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersNth<ImMemchrNthAVX512, ImMemchrRequiredAVX512>), "ImMemchrNthShort_AVX512")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersNth<ImMemchrNthAVX2_UNROLL, ImMemchrRequiredAVX2>), "ImMemchrNthShort_AVX2_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersNth<ImMemchrNthAVX2, ImMemchrRequiredAVX2>), "ImMemchrNthShort_AVX2")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersNth<ImMemchrNthSSE4_2_UNROLL, ImMemchrRequiredSSE4_2>), "ImMemchrNthShort_SSE4_2_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersNth<ImMemchrNthSSE4_2, ImMemchrRequiredSSE4_2>), "ImMemchrNthShort_SSE4_2")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersNth<ImMemchrNthSSE_UNROLL, ImMemchrRequiredSSE2>), "ImMemchrNthShort_SSE_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersNth<ImMemchrNthSSE, ImMemchrRequiredSSE2>), "ImMemchrNthShort_SSE")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, (BM_ShortBuffersNth<ImMemchrNthCSTD, ImCpuFeatureFlags_None>), "ImMemchrNthShort_CSTD")
+
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersOffsets_AVX512_VBMI2, "ImMemchrOffsetsShort_AVX512_VBMI2")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersOffsets_AVX512, "ImMemchrOffsetsShort_AVX512")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersOffsets_AVX2, "ImMemchrOffsetsShort_AVX2")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersOffsets_SSE, "ImMemchrOffsetsShort_SSE")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersOffsets_CSTD, "ImMemchrOffsetsShort_CSTD")
+BENCHMARK_FROM_CONFIG_LOADER(short_buffers_config_loader, BM_ShortBuffersOffsets64_AVX512_VBMI2, "ImMemchrOffsets64Short_AVX512_VBMI2")
+
+BENCHMARK_FROM_CONFIG_LOADER(short_strings_config_loader, BM_ShortStrings_DISPATCH, "ImMemchrStrings_DISPATCH")
+BENCHMARK_FROM_CONFIG_LOADER(short_strings_config_loader, BM_ShortStrings_AVX512_MASKED, "ImMemchrStrings_AVX512_MASKED")
+BENCHMARK_FROM_CONFIG_LOADER(short_strings_config_loader, BM_ShortStrings_AVX512, "ImMemchrStrings_AVX512")
+BENCHMARK_FROM_CONFIG_LOADER(short_strings_config_loader, BM_ShortStrings_AVX2_UNROLL, "ImMemchrStrings_AVX2_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_strings_config_loader, BM_ShortStrings_AVX2, "ImMemchrStrings_AVX2")
+BENCHMARK_FROM_CONFIG_LOADER(short_strings_config_loader, BM_ShortStrings_SSE4_2, "ImMemchrStrings_SSE4_2")
+BENCHMARK_FROM_CONFIG_LOADER(short_strings_config_loader, BM_ShortStrings_SSE_UNROLL, "ImMemchrStrings_SSE_UNROLL")
+BENCHMARK_FROM_CONFIG_LOADER(short_strings_config_loader, BM_ShortStrings_SSE, "ImMemchrStrings_SSE")
+BENCHMARK_FROM_CONFIG_LOADER(short_strings_config_loader, BM_ShortStrings_CSTD, "ImMemchrStrings_CSTD")
+
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllMatches_AVX512, "ImMemchrAll_AVX512")
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllMatches_AVX2, "ImMemchrAll_AVX2")
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllMatches_SSE, "ImMemchrAll_SSE")
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllMatches_CSTD, "ImMemchrAll_CSTD")
+
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_LineIndex_PushBack, "ImLineIndex_PushBack")
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_LineIndex_AVX512_VBMI2, "ImLineIndex_AVX512_VBMI2")
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_LineIndex64_AVX512_VBMI2, "ImLineIndex64_AVX512_VBMI2")
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_LineIndex_AVX512, "ImLineIndex_AVX512")
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_LineIndex64_AVX512, "ImLineIndex64_AVX512")
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_LineIndex_AVX2, "ImLineIndex_AVX2")
+BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_LineIndex64_AVX2, "ImLineIndex64_AVX2")
+
+BENCHMARK_PARALLEL_THREADS(parallel_config_loader, Early, "ImMemchrParallel")
+BENCHMARK_PARALLEL_THREADS(parallel_config_loader, Middle, "ImMemchrParallel")
+BENCHMARK_PARALLEL_THREADS(parallel_config_loader, None, "ImMemchrParallel")
+
+static const int pool_benchmarks_registered = register_pool_benchmarks(threads_config_loader);
+
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountAVX512_PREFETCH, ImMemchrRequiredAVX512, "ImMemcount_AVX512_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountAVX512, ImMemchrRequiredAVX512, "ImMemcount_AVX512")
+
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountAVX2_UNROLL_PREFETCH, ImMemchrRequiredAVX2, "ImMemcount_AVX2_UNROLL_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountAVX2_UNROLL, ImMemchrRequiredAVX2, "ImMemcount_AVX2_UNROLL")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountAVX2_PREFETCH, ImMemchrRequiredAVX2, "ImMemcount_AVX2_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountAVX2, ImMemchrRequiredAVX2, "ImMemcount_AVX2")
+
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountSSE4_2_UNROLL_PREFETCH, ImMemchrRequiredSSE4_2, "ImMemcount_SSE4_2_UNROLL_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountSSE4_2_UNROLL, ImMemchrRequiredSSE4_2, "ImMemcount_SSE4_2_UNROLL")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountSSE4_2_PREFETCH, ImMemchrRequiredSSE4_2, "ImMemcount_SSE4_2_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountSSE4_2, ImMemchrRequiredSSE4_2, "ImMemcount_SSE4_2")
+
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountSSE_UNROLL_PREFETCH, ImMemchrRequiredSSE2, "ImMemcount_SSE_UNROLL_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountSSE_UNROLL, ImMemchrRequiredSSE2, "ImMemcount_SSE_UNROLL")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountSSE_PREFETCH, ImMemchrRequiredSSE2, "ImMemcount_SSE_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountSSE, ImMemchrRequiredSSE2, "ImMemcount_SSE")
+
+BENCHMARK_LINE_SIZES(BM_Memcount, ImMemcountCSTD, ImCpuFeatureFlags_None, "ImMemcount_CSTD")
+
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthAVX512_PREFETCH, ImMemchrRequiredAVX512, "ImMemchrNth_AVX512_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthAVX512, ImMemchrRequiredAVX512, "ImMemchrNth_AVX512")
+
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthAVX2_UNROLL_PREFETCH, ImMemchrRequiredAVX2, "ImMemchrNth_AVX2_UNROLL_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthAVX2_UNROLL, ImMemchrRequiredAVX2, "ImMemchrNth_AVX2_UNROLL")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthAVX2_PREFETCH, ImMemchrRequiredAVX2, "ImMemchrNth_AVX2_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthAVX2, ImMemchrRequiredAVX2, "ImMemchrNth_AVX2")
+
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthSSE4_2_UNROLL_PREFETCH, ImMemchrRequiredSSE4_2, "ImMemchrNth_SSE4_2_UNROLL_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthSSE4_2_UNROLL, ImMemchrRequiredSSE4_2, "ImMemchrNth_SSE4_2_UNROLL")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthSSE4_2_PREFETCH, ImMemchrRequiredSSE4_2, "ImMemchrNth_SSE4_2_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthSSE4_2, ImMemchrRequiredSSE4_2, "ImMemchrNth_SSE4_2")
+
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthSSE_UNROLL_PREFETCH, ImMemchrRequiredSSE2, "ImMemchrNth_SSE_UNROLL_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthSSE_UNROLL, ImMemchrRequiredSSE2, "ImMemchrNth_SSE_UNROLL")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthSSE_PREFETCH, ImMemchrRequiredSSE2, "ImMemchrNth_SSE_PREFETCH")
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthSSE, ImMemchrRequiredSSE2, "ImMemchrNth_SSE")
+
+BENCHMARK_LINE_SIZES(BM_MemchrNth, ImMemchrNthCSTD, ImCpuFeatureFlags_None, "ImMemchrNth_CSTD")
+
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmem>, ImCpuFeatureFlags_None, "ImMemmem_DISPATCH")
+
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemAVX512_PREFETCH>, ImMemchrRequiredAVX512, "ImMemmem_AVX512_PREFETCH")
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemAVX512>, ImMemchrRequiredAVX512, "ImMemmem_AVX512")
+
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemAVX2_UNROLL_PREFETCH>, ImMemchrRequiredAVX2, "ImMemmem_AVX2_UNROLL_PREFETCH")
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemAVX2_UNROLL>, ImMemchrRequiredAVX2, "ImMemmem_AVX2_UNROLL")
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemAVX2_PREFETCH>, ImMemchrRequiredAVX2, "ImMemmem_AVX2_PREFETCH")
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemAVX2>, ImMemchrRequiredAVX2, "ImMemmem_AVX2")
+
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemSSE_UNROLL_PREFETCH>, ImMemchrRequiredSSE2, "ImMemmem_SSE_UNROLL_PREFETCH")
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemSSE_UNROLL>, ImMemchrRequiredSSE2, "ImMemmem_SSE_UNROLL")
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemSSE_PREFETCH>, ImMemchrRequiredSSE2, "ImMemmem_SSE_PREFETCH")
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemSSE>, ImMemchrRequiredSSE2, "ImMemmem_SSE")
+
+BENCHMARK_NEEDLES(MemmemSearcher<ImMemmemCSTD>, ImCpuFeatureFlags_None, "ImMemmem_CSTD")
+BENCHMARK_NEEDLES(StringViewSearcher, ImCpuFeatureFlags_None, "StringView_find")
+BENCHMARK_NEEDLES(HorspoolSearcher, ImCpuFeatureFlags_None, "Search_Horspool")
+
+BENCHMARK_SET_SIZES(ByteSetSearcher<ImMemchrSet>, ImCpuFeatureFlags_None, "ImMemchrSet_DISPATCH")
+BENCHMARK_SET_SIZES(ByteSetSearcher<ImMemchrSetAVX512_VBMI>, ImMemchrRequiredAVX512_VBMI, "ImMemchrSet_AVX512_VBMI")
+BENCHMARK_SET_SIZES(ByteSetSearcher<ImMemchrSetAVX2>, ImMemchrRequiredAVX2, "ImMemchrSet_AVX2")
+BENCHMARK_SET_SIZES(ByteSetSearcher<ImMemchrSetSSSE3>, ImMemchrRequiredSSSE3, "ImMemchrSet_SSSE3")
+BENCHMARK_SET_SIZES(ByteSetSearcher<ImMemchrSetScalar>, ImCpuFeatureFlags_None, "ImMemchrSet_Scalar")
+BENCHMARK_SET_SIZES(ChainedMemchrSearcher, ImCpuFeatureFlags_None, "ImMemchr_Chained")
+BENCHMARK_SET_SIZES(StrpbrkSearcher, ImCpuFeatureFlags_None, "strpbrk")
+
+// --prefetch_autotune sweeps the prefetch settings of each ISA over the config buffer sizes, keeps the
+// settings with the best geometric mean throughput and writes them to the profile ImMemchr loads
+struct PrefetchTuneKernel
+{
+  ImMemchrIsa isa;
+  ImMemchrFunc func;
+  ImCpuFeatureFlags required;
+};
+
+static const PrefetchTuneKernel prefetch_tune_kernels[] =
+{
+  { ImMemchrIsa_AVX512, ImMemchrAVX512_PREFETCH,      ImMemchrRequiredAVX512 },
+  { ImMemchrIsa_AVX2,   ImMemchrAVX2_UNROLL_PREFETCH, ImMemchrRequiredAVX2 },
+  { ImMemchrIsa_SSE4_2, ImMemchrSSE4_2_PREFETCH,      ImMemchrRequiredSSE4_2 },
+  { ImMemchrIsa_SSE,    ImMemchrSSE_UNROLL_PREFETCH,  ImMemchrRequiredSSE2 },
+};
+
+static std::vector<ImPrefetchSettings> prefetch_tune_candidates()
+{
+  std::vector<ImPrefetchSettings> candidates;
+  candidates.push_back({ 0, ImPrefetchHint_T0, 1 }); // No prefetch
+
+  for (size_t distance : { 256, 512, 1024, 2048, 4096, 8192 })
+    for (ImPrefetchHint hint = 0; hint < ImPrefetchHint_COUNT; hint++)
+      for (size_t every_lines : { 1, 2, 4, 8 })
+        candidates.push_back({ distance, hint, every_lines });
+
+  return candidates;
+}
+
+static int prefetch_autotune(const benchcfg::BenchConfig& config)
+{
+  const benchcfg::BenchConfig::ValueRange value_range =
+    config.value_range.get().get().value_or(benchcfg::BenchConfig::ValueRange{ 1 << 20, 1 << 30 });
+  const std::vector<ImPrefetchSettings> candidates = prefetch_tune_candidates();
+
+  std::vector<size_t> sizes;
+  for (int64_t size = value_range.start; size < value_range.limit; size *= 8)
+    sizes.push_back(size);
+  sizes.push_back(value_range.limit);
+
+  // Sum of log throughput per kernel and candidate, the best sum is the best geometric mean over sizes
+  std::vector<std::vector<double>> log_sums(std::size(prefetch_tune_kernels), std::vector<double>(candidates.size()));
+
+  for (size_t size : sizes)
+  {
+    TestData data(size);
+    std::string_view strv = data.get_str();
+
+    for (size_t k = 0; k < std::size(prefetch_tune_kernels); k++)
+    {
+      const PrefetchTuneKernel& kernel = prefetch_tune_kernels[k];
+
+      if (!ImHasCpuFeatures(kernel.required))
+        continue;
+
+      ImPrefetchSettings& settings = ImGetPrefetchSettings(kernel.isa);
+      size_t best = 0;
+      double best_throughput = 0;
+
+      for (size_t c = 0; c < candidates.size(); c++)
+      {
+        settings = candidates[c];
+        double throughput = measure_scan(kernel.func, strv.data(), strv.size());
+        log_sums[k][c] += std::log(throughput);
+
+        if (throughput > best_throughput)
+        {
+          best_throughput = throughput;
+          best = c;
+        }
+      }
+
+      fmt::println("{:<8} size {:>12}: distance {:>5}, hint {:<3}, every {} lines, {:.2f} GB/s",
+        ImMemchrIsaNames[kernel.isa], size, candidates[best].distance, ImPrefetchHintNames[candidates[best].hint],
+        candidates[best].every_lines, best_throughput / 1e9);
+    }
+  }
+
+  for (size_t k = 0; k < std::size(prefetch_tune_kernels); k++)
+  {
+    const PrefetchTuneKernel& kernel = prefetch_tune_kernels[k];
+
+    if (!ImHasCpuFeatures(kernel.required))
+    {
+      fmt::println("{:<8} skipped, instruction set is not supported by this CPU", ImMemchrIsaNames[kernel.isa]);
+      continue;
+    }
+
+    size_t best = std::max_element(log_sums[k].begin(), log_sums[k].end()) - log_sums[k].begin();
+    ImGetPrefetchSettings(kernel.isa) = candidates[best];
+
+    fmt::println("{:<8} selected: distance {}, hint {}, every {} lines",
+      ImMemchrIsaNames[kernel.isa], candidates[best].distance, ImPrefetchHintNames[candidates[best].hint], candidates[best].every_lines);
+  }
+
+  if (!ImSavePrefetchProfile(IMGUI_PREFETCH_PROFILE_PATH))
+  {
+    fmt::println("Error: failed to write {}", IMGUI_PREFETCH_PROFILE_PATH);
+    return 1;
+  }
+
+  fmt::println("Prefetch profile written to {}", IMGUI_PREFETCH_PROFILE_PATH);
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  buffer_page_length = config_loader.getConfig().page_size.get().get().value_or(IMGUI_SMALL_PAGE_LENGTH);
+
+  if (buffer_page_length != IMGUI_SMALL_PAGE_LENGTH && buffer_page_length != IMGUI_HUGE_PAGE_LENGTH)
+  {
+    fmt::println("Error: page_size must be {} or {}", IMGUI_SMALL_PAGE_LENGTH, IMGUI_HUGE_PAGE_LENGTH);
+    return 1;
+  }
+
+  dataset_cache_budget = config_loader.getConfig().dataset_cache_size.get().get().value_or(dataset_cache_budget);
+  test_data_seed = config_loader.getConfig().dataset_seed.get().get().value_or(test_data_seed);
+
+  if (auto dir = config_loader.getConfig().dataset_dir.get().get(); dir.has_value() && !dir->empty())
+    dataset_dir = fs::current_path() / dir.value();
+
+  perf_counter_events = config_loader.getConfig().perf_counters.get().get().value_or(std::vector<std::string>{});
+
+  for (const std::string& event : perf_counter_events)
+  {
+    if (std::ranges::find(ImPerfEventNames, event) == std::end(ImPerfEventNames))
+      fmt::println("Warning: unknown perf counter {}", event);
+  }
+
+  if (ImPerfCounters perf_counters; !perf_counter_events.empty() && !perf_counters.Open(perf_counter_events))
+  {
+    fmt::println("Warning: perf counters are not available, check perf_event_paranoid, reporting time only");
+    perf_counter_events.clear();
+  }
+  else if (!perf_counter_events.empty())
+  {
+    for (const std::string& event : perf_counter_events)
+    {
+      bool opened = false;
+      for (size_t i = 0; i < perf_counters.GetCount() && !opened; i++)
+        opened = perf_counters.GetName(i) == event;
+
+      if (!opened && std::ranges::find(ImPerfEventNames, event) != std::end(ImPerfEventNames))
+        fmt::println("Warning: perf counter {} cannot be counted on this CPU, skipped", event);
+    }
+
+    if (perf_counters.GetGroupCount() > 1)
+      fmt::println("Warning: the PMU cannot count all perf counters at once, they are split into {} multiplexed groups", perf_counters.GetGroupCount());
+  }
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::string_view(argv[i]) == "--prefetch_autotune")
+      return prefetch_autotune(config_loader.getConfig());
+  }
 
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_SSE4_2_UNROLL_PREFETCH, "ImMemchr_SSE4_2_UNROLL_PREFETCH")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_SSE4_2_UNROLL, "ImMemchr_SSE4_2_UNROLL")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_SSE4_2_PREFETCH, "ImMemchr_SSE4_2_PREFETCH")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_SSE4_2, "ImMemchr_SSE4_2")
+  benchmark::Initialize(&argc, argv);
+  benchmark::AddCustomContext("page_size", std::to_string(buffer_page_length));
 
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_SSE_UNROLL_PREFETCH, "ImMemchr_SSE_UNROLL_PREFETCH")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_SSE_UNROLL, "ImMemchr_SSE_UNROLL")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_SSE_PREFETCH,  "ImMemchr_SSE_PREFETCH")
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_SSE, "ImMemchr_SSE")
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
 
-BENCHMARK_FROM_CONFIG_LOADER(config_loader, BM_AllLines_CSTD, "ImMemchr_CSTD")
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
 
-BENCHMARK_MAIN();
\ No newline at end of file
+  return 0;
+}
\ No newline at end of file
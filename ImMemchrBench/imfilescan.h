@@ -0,0 +1,259 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "immemchr.h"
+
+// Bytes scanned between two advice calls, large enough to amortize the system call
+#define IMGUI_FILE_SCAN_WINDOW_LENGTH (8 * 1024 * 1024)
+
+// Read-ahead threads touch one byte per page, the smallest page size the mapping can have
+#define IMGUI_FILE_SCAN_PAGE_LENGTH 4096
+
+struct ImFileLineScannerSettings
+{
+  size_t window_length = IMGUI_FILE_SCAN_WINDOW_LENGTH;
+  size_t advise_ahead_windows = 4;     // Windows requested with MADV_WILLNEED / PrefetchVirtualMemory ahead of the cursor
+  unsigned int read_ahead_threads = 0; // Threads faulting the pages of the next windows in before the scan reaches them
+  bool huge_pages = false;             // MADV_HUGEPAGE on the mapping, only honored by file systems with file THP
+  bool sequential = true;              // MADV_SEQUENTIAL / FILE_FLAG_SEQUENTIAL_SCAN, off for mappings searched many times
+};
+
+// Read-only mapping of a whole file scanned for lines. The mapping is advised sequential, the windows ahead of the
+// scan cursor are requested from the page cache, and optional read-ahead threads take the page faults of the next
+// windows off the scanning thread. Newlines are found by the best ImMemchrAll kernel of the CPU.
+class ImFileLineScanner
+{
+public:
+  ImFileLineScanner() = default;
+
+  explicit ImFileLineScanner(const char* path, const ImFileLineScannerSettings& settings = ImFileLineScannerSettings())
+  {
+    Open(path, settings);
+  }
+
+  ~ImFileLineScanner()
+  {
+    Close();
+  }
+
+  ImFileLineScanner(const ImFileLineScanner&) = delete;
+  ImFileLineScanner& operator=(const ImFileLineScanner&) = delete;
+
+  bool Open(const char* path, const ImFileLineScannerSettings& new_settings = ImFileLineScannerSettings())
+  {
+    Close();
+    settings = new_settings;
+    settings.window_length = std::max<size_t>(settings.window_length, IMGUI_FILE_SCAN_PAGE_LENGTH) & ~size_t(IMGUI_FILE_SCAN_PAGE_LENGTH - 1);
+
+#if defined(_WIN32)
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, settings.sequential ? FILE_FLAG_SEQUENTIAL_SCAN : 0, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+    {
+      Close();
+      return false;
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    data = mapping ? (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    size = data ? (size_t)file_size.QuadPart : 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+      void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (view != MAP_FAILED)
+      {
+        data = (const char*)view;
+        size = (size_t)st.st_size;
+
+        if (settings.sequential)
+          madvise(view, size, MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+        if (settings.huge_pages)
+          madvise(view, size, MADV_HUGEPAGE);
+#endif
+      }
+    }
+
+    close(fd);
+#endif
+
+    if (!data)
+      Close();
+
+    return data != nullptr;
+  }
+
+  void Close()
+  {
+#if defined(_WIN32)
+    if (data)
+      UnmapViewOfFile(data);
+    if (mapping)
+      CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+      CloseHandle(file);
+
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+#else
+    if (data)
+      munmap((void*)data, size);
+#endif
+
+    data = nullptr;
+    size = 0;
+  }
+
+  bool IsOpen() const
+  {
+    return data != nullptr;
+  }
+
+  const char* GetData() const
+  {
+    return data;
+  }
+
+  size_t GetSize() const
+  {
+    return size;
+  }
+
+  // Calls callback(offset) for every '\n' of the file in order, the callback may return false to stop.
+  // Returns the number of newlines passed to the callback.
+  template <class Callback> requires std::invocable<Callback&, size_t>
+  size_t ForEachNewline(Callback&& callback)
+  {
+    if (!data)
+      return 0;
+
+    const size_t window_count = (size + settings.window_length - 1) / settings.window_length;
+
+    std::atomic<size_t> scan_window = 0;
+    std::atomic<size_t> next_touch_window = 1;
+    std::vector<std::thread> readers;
+
+    for (unsigned int i = 0; i < settings.read_ahead_threads; i++)
+      readers.emplace_back([&] { ReadAhead(scan_window, next_touch_window, window_count); });
+
+    for (size_t window = 0; window < settings.advise_ahead_windows && window < window_count; window++)
+      AdviseWillNeed(window);
+
+    size_t found = 0;
+    bool stopped = false;
+
+    for (size_t window = 0; window < window_count && !stopped; window++)
+    {
+      scan_window.store(window, std::memory_order_relaxed);
+
+      if (window + settings.advise_ahead_windows < window_count)
+        AdviseWillNeed(window + settings.advise_ahead_windows);
+
+      const size_t begin = window * settings.window_length;
+      const size_t length = std::min(settings.window_length, size - begin);
+
+      found += ImMemchrAll(data + begin, '\n', length, [&](size_t offset)
+      {
+        if (!ImMemchrAllEmit(callback, begin + offset))
+          stopped = true;
+
+        return !stopped;
+      });
+    }
+
+    scan_window.store(window_count, std::memory_order_relaxed);
+
+    for (std::thread& reader : readers)
+      reader.join();
+
+    return found;
+  }
+
+  size_t CountLines()
+  {
+    return ForEachNewline([](size_t) {});
+  }
+
+private:
+  void AdviseWillNeed(size_t window)
+  {
+    const size_t begin = window * settings.window_length;
+    const size_t length = std::min(settings.window_length, size - begin);
+
+#if defined(_WIN32)
+    WIN32_MEMORY_RANGE_ENTRY range = { (PVOID)(data + begin), length };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    madvise((void*)(data + begin), length, MADV_WILLNEED);
+#endif
+  }
+
+  // Takes the next untouched window, but never more than advise_ahead_windows ahead of the scan
+  void ReadAhead(const std::atomic<size_t>& scan_window, std::atomic<size_t>& next_touch_window, size_t window_count)
+  {
+    const size_t ahead = std::max<size_t>(settings.advise_ahead_windows, 1);
+
+    for (;;)
+    {
+      const size_t window = next_touch_window.fetch_add(1, std::memory_order_relaxed);
+
+      if (window >= window_count)
+        return;
+
+      while (window > scan_window.load(std::memory_order_relaxed) + ahead)
+        std::this_thread::yield();
+
+      if (window < scan_window.load(std::memory_order_relaxed) || scan_window.load(std::memory_order_relaxed) >= window_count)
+        continue;
+
+      const size_t begin = window * settings.window_length;
+      const size_t end = std::min(begin + settings.window_length, size);
+      unsigned char sink = 0;
+
+      for (size_t offset = begin; offset < end; offset += IMGUI_FILE_SCAN_PAGE_LENGTH)
+        sink ^= ((const volatile unsigned char*)data)[offset];
+
+      (void)sink;
+    }
+  }
+
+private:
+  ImFileLineScannerSettings settings;
+
+#if defined(_WIN32)
+  HANDLE file = INVALID_HANDLE_VALUE;
+  HANDLE mapping = nullptr;
+#endif
+  const char* data = nullptr;
+  size_t size = 0;
+};
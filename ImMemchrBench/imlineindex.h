@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "immemchr.h"
+#include "imparallel.h"
+
+// Bytes scanned per kernel call. The output is grown before each segment, so kernels never check capacity.
+#define IMGUI_LINE_INDEX_SEGMENT_LENGTH (64 * 1024)
+
+// Growable offset array without zero-fill, every entry is written by a kernel before it is read
+template <class T>
+struct ImOffsetBuffer
+{
+  std::unique_ptr<T[]> data;
+  size_t size = 0;
+  size_t capacity = 0;
+
+  void Reserve(size_t new_capacity)
+  {
+    if (new_capacity <= capacity)
+      return;
+
+    new_capacity = std::max(new_capacity, capacity * 2);
+
+    std::unique_ptr<T[]> grown = std::make_unique_for_overwrite<T[]>(new_capacity);
+    std::copy(data.get(), data.get() + size, grown.get());
+
+    data = std::move(grown);
+    capacity = new_capacity;
+  }
+};
+
+template <class OffsetT>
+class ImLineIndexParallelJob;
+
+// One-pass line index of a text buffer. Line i spans [GetLineStart(i), GetLineStart(i + 1) - 1), the last line
+// ends at the buffer size. Newline positions are written straight into a preallocated array by the offset kernels.
+// With a 32-bit OffsetT they are stored relative to 4 GB blocks, which halves the index compared to size_t offsets.
+template <class OffsetT>
+class ImLineIndexT
+{
+public:
+  static constexpr bool IS_BLOCKED = sizeof(OffsetT) < sizeof(size_t);
+  static constexpr size_t BLOCK_LENGTH = IS_BLOCKED ? size_t(1) << (sizeof(OffsetT) * 8) : SIZE_MAX;
+
+  void Reserve(size_t capacity)
+  {
+    newlines.Reserve(capacity);
+  }
+
+  void Build(const char* buf, size_t size, ImMemchrOffsetsFunc<OffsetT> kernel = ImMemchrSelectOffsets<OffsetT>())
+  {
+    newlines.size = 0;
+    block_first_newline.clear();
+
+    for (size_t block_start = 0; block_start < size; )
+    {
+      const size_t block_end = size - block_start > BLOCK_LENGTH ? block_start + BLOCK_LENGTH : size;
+
+      block_first_newline.push_back(newlines.size);
+      Scan(buf, block_start, block_end, newlines, kernel);
+
+      block_start = block_end;
+    }
+  }
+
+  // Same index as Build, with the buffer split across the pool, see ImLineIndexParallelJob
+  void BuildParallel(const char* buf, size_t size, ImThreadPool& pool, ImMemchrOffsetsFunc<OffsetT> kernel = ImMemchrSelectOffsets<OffsetT>())
+  {
+    if (size < IMGUI_PARALLEL_MIN_LENGTH || pool.GetThreadCount() <= 1)
+    {
+      Build(buf, size, kernel);
+      return;
+    }
+
+    ImLineIndexParallelJob<OffsetT> job(buf, size, pool.GetThreadCount(), kernel);
+
+    pool.ParallelFor(pool.GetThreadCount(), [&](size_t thread) { job.Scan((unsigned int)thread); });
+    job.PrefixSum(*this);
+    pool.ParallelFor(pool.GetThreadCount(), [&](size_t thread) { job.Merge((unsigned int)thread, *this); });
+  }
+
+  size_t GetLineCount() const
+  {
+    return newlines.size + 1;
+  }
+
+  size_t GetLineStart(size_t line) const
+  {
+    return line == 0 ? 0 : GetNewlinePos(line - 1) + 1;
+  }
+
+  size_t GetNewlinePos(size_t index) const
+  {
+    if constexpr (IS_BLOCKED)
+    {
+      size_t block = std::upper_bound(block_first_newline.begin(), block_first_newline.end(), index) - block_first_newline.begin() - 1;
+      return block * BLOCK_LENGTH + newlines.data[index];
+    }
+    else
+    {
+      return newlines.data[index];
+    }
+  }
+
+  size_t GetMemoryUsage() const
+  {
+    return newlines.capacity * sizeof(OffsetT) + block_first_newline.capacity() * sizeof(size_t);
+  }
+
+  // Appends the newline positions of [begin, end), which must not cross a block boundary
+  static void Scan(const char* buf, size_t begin, size_t end, ImOffsetBuffer<OffsetT>& out, ImMemchrOffsetsFunc<OffsetT> kernel)
+  {
+    for (size_t segment = begin; segment < end; segment += IMGUI_LINE_INDEX_SEGMENT_LENGTH)
+    {
+      const size_t length = std::min<size_t>(IMGUI_LINE_INDEX_SEGMENT_LENGTH, end - segment);
+      const OffsetT base = (OffsetT)(IS_BLOCKED ? segment & (BLOCK_LENGTH - 1) : segment);
+
+      out.Reserve(out.size + length);
+      out.size += kernel(buf + segment, '\n', length, base, out.data.get() + out.size);
+    }
+  }
+
+private:
+  friend class ImLineIndexParallelJob<OffsetT>;
+
+  ImOffsetBuffer<OffsetT> newlines;
+
+  // Index of the first newline of each block
+  std::vector<size_t> block_first_newline;
+};
+
+// Parallel line index in three phases. Every thread indexes its own contiguous range of chunks into a
+// thread-local buffer, a prefix sum over the per-chunk counts gives every chunk its slot in the global array,
+// and every thread copies its own chunks there, so no thread copies the whole index.
+// The phases are driven by the caller (ImThreadPool or any other set of threads), with a barrier between them.
+template <class OffsetT>
+class ImLineIndexParallelJob
+{
+public:
+  static_assert(ImLineIndexT<OffsetT>::BLOCK_LENGTH % IMGUI_PARALLEL_CHUNK_LENGTH == 0 || !ImLineIndexT<OffsetT>::IS_BLOCKED,
+    "Chunks must not cross a block boundary");
+
+  ImLineIndexParallelJob(const char* buf, size_t size, unsigned int thread_count, ImMemchrOffsetsFunc<OffsetT> kernel = ImMemchrSelectOffsets<OffsetT>())
+    : buf(buf), size(size), thread_count(thread_count), kernel(kernel),
+      chunk_count((size + IMGUI_PARALLEL_CHUNK_LENGTH - 1) / IMGUI_PARALLEL_CHUNK_LENGTH),
+      thread_buffers(thread_count), chunk_counts(chunk_count), chunk_local_start(chunk_count), chunk_global_start(chunk_count)
+  {
+  }
+
+  // Phase 1, once per thread
+  void Scan(unsigned int thread)
+  {
+    ImOffsetBuffer<OffsetT>& buffer = thread_buffers[thread];
+    buffer.size = 0;
+
+    for (size_t chunk = GetFirstChunk(thread); chunk < GetFirstChunk(thread + 1); chunk++)
+    {
+      const size_t chunk_start = chunk * IMGUI_PARALLEL_CHUNK_LENGTH;
+      const size_t chunk_end = std::min(size, chunk_start + IMGUI_PARALLEL_CHUNK_LENGTH);
+
+      chunk_local_start[chunk] = buffer.size;
+      ImLineIndexT<OffsetT>::Scan(buf, chunk_start, chunk_end, buffer, kernel);
+      chunk_counts[chunk] = buffer.size - chunk_local_start[chunk];
+    }
+  }
+
+  // Phase 2, on a single thread. Only walks the per-chunk counts and sizes the index.
+  void PrefixSum(ImLineIndexT<OffsetT>& index)
+  {
+    size_t total = 0;
+
+    for (size_t chunk = 0; chunk < chunk_count; chunk++)
+    {
+      chunk_global_start[chunk] = total;
+      total += chunk_counts[chunk];
+    }
+
+    index.newlines.size = 0;
+    index.newlines.Reserve(total);
+    index.newlines.size = total;
+    index.block_first_newline.clear();
+
+    const size_t chunks_per_block = ImLineIndexT<OffsetT>::IS_BLOCKED ? ImLineIndexT<OffsetT>::BLOCK_LENGTH / IMGUI_PARALLEL_CHUNK_LENGTH : chunk_count;
+
+    for (size_t chunk = 0; chunk < chunk_count; chunk += chunks_per_block)
+      index.block_first_newline.push_back(chunk_global_start[chunk]);
+  }
+
+  // Phase 3, once per thread
+  void Merge(unsigned int thread, ImLineIndexT<OffsetT>& index)
+  {
+    const ImOffsetBuffer<OffsetT>& buffer = thread_buffers[thread];
+
+    for (size_t chunk = GetFirstChunk(thread); chunk < GetFirstChunk(thread + 1); chunk++)
+    {
+      memcpy(index.newlines.data.get() + chunk_global_start[chunk],
+        buffer.data.get() + chunk_local_start[chunk],
+        chunk_counts[chunk] * sizeof(OffsetT));
+    }
+  }
+
+private:
+  size_t GetFirstChunk(unsigned int thread) const
+  {
+    return chunk_count * thread / thread_count;
+  }
+
+private:
+  const char* buf;
+  size_t size;
+  unsigned int thread_count;
+  ImMemchrOffsetsFunc<OffsetT> kernel;
+  size_t chunk_count;
+
+  std::vector<ImOffsetBuffer<OffsetT>> thread_buffers;
+  std::vector<size_t> chunk_counts;
+  std::vector<size_t> chunk_local_start;
+  std::vector<size_t> chunk_global_start;
+};
+
+using ImLineIndex = ImLineIndexT<uint32_t>;
+using ImLineIndex64 = ImLineIndexT<uint64_t>;
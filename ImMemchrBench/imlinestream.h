@@ -0,0 +1,293 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "immemchr.h"
+
+// Bytes read per chunk, one chunk is scanned while the next one is read
+#define IMGUI_LINE_STREAM_CHUNK_LENGTH (256 * 1024)
+
+struct ImLineStreamSettings
+{
+  size_t chunk_length = IMGUI_LINE_STREAM_CHUNK_LENGTH;
+  size_t carry_length = IMGUI_LINE_STREAM_CHUNK_LENGTH; // Longest partial line carried in front of the next chunk without a separate buffer
+  bool fill_chunks = false;                            // Keeps reading until a chunk is full, otherwise each read is scanned as soon as it returns
+};
+
+// Reads a file descriptor, a pipe or stdin. Returns the number of bytes read, 0 at the end of the stream and
+// a negative value on error. A read interrupted by a signal is retried.
+struct ImLineStreamFileReader
+{
+#if defined(_WIN32)
+  HANDLE file = GetStdHandle(STD_INPUT_HANDLE);
+
+  ptrdiff_t operator()(char* buf, size_t capacity) const
+  {
+    DWORD read_size = 0;
+
+    if (!ReadFile(file, buf, (DWORD)std::min<size_t>(capacity, MAXDWORD), &read_size, nullptr))
+      return GetLastError() == ERROR_BROKEN_PIPE ? 0 : -1;
+
+    return (ptrdiff_t)read_size;
+  }
+#else
+  int fd = STDIN_FILENO;
+
+  ptrdiff_t operator()(char* buf, size_t capacity) const
+  {
+    ptrdiff_t read_size;
+
+    do
+      read_size = (ptrdiff_t)read(fd, buf, capacity);
+    while (read_size < 0 && errno == EINTR);
+
+    return read_size;
+  }
+#endif
+};
+
+// Line splitter for streams that cannot be mapped. Chunks are double-buffered: a reader thread fills the next
+// chunk while the current one is scanned by the best ImMemchrAll kernel of the CPU. Every chunk buffer keeps
+// carry_length bytes in front of its data, the partial line at the end of a chunk is copied there, in front of
+// the next chunk, so each line is handed out as one contiguous view. Only a line longer than carry_length is
+// gathered in a separate buffer.
+class ImLineStreamSplitter
+{
+public:
+  explicit ImLineStreamSplitter(const ImLineStreamSettings& settings = ImLineStreamSettings())
+    : settings(settings)
+  {
+    this->settings.chunk_length = std::max<size_t>(this->settings.chunk_length, 1);
+
+    for (Slot& slot : slots)
+      slot.buf = std::make_unique_for_overwrite<char[]>(this->settings.carry_length + this->settings.chunk_length);
+  }
+
+  ImLineStreamSplitter(const ImLineStreamSplitter&) = delete;
+  ImLineStreamSplitter& operator=(const ImLineStreamSplitter&) = delete;
+
+  // Calls callback(std::string_view line) for every line of the stream, without its '\n'. A view is valid until
+  // the callback returns, which may return false to stop. The last line is passed even if it has no '\n'.
+  // Reader is called as reader(char* buf, size_t capacity), see ImLineStreamFileReader.
+  // Returns the number of lines passed to the callback. A stop waits for a read already in progress to return.
+  // A read error ends the stream after the lines read before it, without the partial line it cut, and is
+  // reported by HasReadError().
+  template <class Reader, class Callback> requires std::invocable<Callback&, std::string_view>
+  size_t Split(Reader&& reader, Callback&& callback)
+  {
+    for (Slot& slot : slots)
+    {
+      slot.filled = false;
+      slot.length = 0;
+    }
+
+    stopping = false;
+    read_error = false;
+
+    std::thread read_thread([&] { ReadLoop(reader); });
+
+    size_t lines = 0;
+    size_t carry_size = 0;
+    bool stopped = false;
+    long_line.clear();
+
+    size_t chunk = 0;
+
+    for (; !stopped; chunk++)
+    {
+      Slot& slot = slots[chunk & 1];
+      Slot& next_slot = slots[(chunk + 1) & 1];
+
+      {
+        std::unique_lock lock(slot_mutex);
+        slot_cv.wait(lock, [&] { return slot.filled; });
+      }
+
+      if (slot.length <= 0)
+        break;
+
+      char* data = slot.buf.get() + settings.carry_length;
+      const size_t length = (size_t)slot.length;
+      const char* line_start = data - carry_size;
+
+      lines += ImMemchrAll(data, '\n', length, [&](size_t offset)
+      {
+        std::string_view line(line_start, size_t(data + offset - line_start));
+
+        if (!long_line.empty())
+        {
+          long_line.append(data, offset);
+          line = long_line;
+        }
+
+        stopped = !Emit(callback, line);
+        long_line.clear();
+        line_start = data + offset + 1;
+
+        return !stopped;
+      });
+
+      if (!stopped)
+      {
+        // Partial line at the end of the chunk, moved in front of the next one or gathered when it is too long
+        const size_t tail_size = size_t(data + length - line_start);
+
+        if (long_line.empty() && tail_size <= settings.carry_length)
+        {
+          std::memcpy(next_slot.buf.get() + settings.carry_length - tail_size, line_start, tail_size);
+          carry_size = tail_size;
+        }
+        else
+        {
+          long_line.append(line_start, tail_size);
+          carry_size = 0;
+        }
+      }
+
+      {
+        std::lock_guard lock(slot_mutex);
+        slot.filled = false;
+        stopping = stopped;
+      }
+
+      slot_cv.notify_all();
+    }
+
+    if (!stopped && !read_error && (carry_size > 0 || !long_line.empty()))
+    {
+      // The end of stream slot holds the carry of the last chunk
+      const char* carry = slots[chunk & 1].buf.get() + settings.carry_length - carry_size;
+      std::string_view line = long_line.empty() ? std::string_view(carry, carry_size) : std::string_view(long_line);
+
+      lines++;
+      Emit(callback, line);
+    }
+
+    {
+      std::lock_guard lock(slot_mutex);
+      stopping = true;
+    }
+
+    slot_cv.notify_all();
+    read_thread.join();
+
+    return lines;
+  }
+
+  template <class Reader>
+  size_t CountLines(Reader&& reader)
+  {
+    return Split(reader, [](std::string_view) {});
+  }
+
+  // Whether the last Split ended on a read error rather than at the end of the stream
+  bool HasReadError() const
+  {
+    return read_error;
+  }
+
+private:
+  struct Slot
+  {
+    std::unique_ptr<char[]> buf;
+    ptrdiff_t length = 0;
+    bool filled = false;
+  };
+
+  template <class Callback>
+  static bool Emit(Callback& callback, std::string_view line)
+  {
+    if constexpr (std::is_void_v<std::invoke_result_t<Callback&, std::string_view>>)
+    {
+      callback(line);
+      return true;
+    }
+    else
+    {
+      return callback(line);
+    }
+  }
+
+  template <class Reader>
+  void ReadLoop(Reader& reader)
+  {
+    bool failed = false;
+
+    for (size_t chunk = 0; ; chunk++)
+    {
+      Slot& slot = slots[chunk & 1];
+
+      {
+        std::unique_lock lock(slot_mutex);
+        slot_cv.wait(lock, [&] { return !slot.filled || stopping; });
+
+        if (stopping)
+          return;
+      }
+
+      char* data = slot.buf.get() + settings.carry_length;
+      ptrdiff_t length = 0;
+
+      // The bytes read before an error are handed out, the next slot then ends the stream
+      while (!failed)
+      {
+        const ptrdiff_t read_size = reader(data + length, settings.chunk_length - (size_t)length);
+
+        if (read_size <= 0)
+        {
+          failed = read_size < 0;
+          break;
+        }
+
+        length += read_size;
+
+        if (!settings.fill_chunks || (size_t)length == settings.chunk_length)
+          break;
+      }
+
+      {
+        std::lock_guard lock(slot_mutex);
+        slot.length = length;
+        slot.filled = true;
+        read_error = failed && length == 0;
+      }
+
+      slot_cv.notify_all();
+
+      if (length <= 0)
+        return;
+    }
+  }
+
+private:
+  ImLineStreamSettings settings;
+
+  Slot slots[2];
+  std::mutex slot_mutex;
+  std::condition_variable slot_cv;
+  bool stopping = false;
+  bool read_error = false;
+
+  std::string long_line;
+};
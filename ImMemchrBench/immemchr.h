@@ -1,794 +1,2951 @@
 #pragma once
 
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <concepts>
+#include <span>
+#include <type_traits>
+
+#if defined(_MSC_VER)
 #include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+
+#define IMGUI_PREFECTH_LENGTH 1024
+
+// Per-function instruction set targets, so that a single build holds every kernel.
+// MSVC allows any intrinsic regardless of /arch, GCC and Clang need the target attribute.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define IMGUI_TARGET(TARGETS)
+#else
+#define IMGUI_TARGET(TARGETS) __attribute__((target(TARGETS)))
+#endif
+
+#define IMGUI_TARGET_AVX512 IMGUI_TARGET("avx512f,avx512bw,bmi,popcnt")
+#define IMGUI_TARGET_AVX512_VBMI2 IMGUI_TARGET("avx512f,avx512bw,avx512vbmi2,bmi,popcnt")
+#define IMGUI_TARGET_AVX512_VBMI IMGUI_TARGET("avx512f,avx512bw,avx512vbmi,bmi,popcnt")
+#define IMGUI_TARGET_AVX2   IMGUI_TARGET("avx2,bmi,popcnt")
+#define IMGUI_TARGET_SSE4_2 IMGUI_TARGET("sse4.2,popcnt")
+#define IMGUI_TARGET_SSSE3  IMGUI_TARGET("ssse3")
+#define IMGUI_TARGET_SSE2   IMGUI_TARGET("sse2")
+
+// Inlines every call of a function into it, used to instantiate the generic kernels under a target
+#if defined(_MSC_VER) && !defined(__clang__)
+#define IMGUI_FLATTEN
+#else
+#define IMGUI_FLATTEN __attribute__((flatten))
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define IMGUI_NOINLINE __declspec(noinline)
+#else
+#define IMGUI_NOINLINE __attribute__((noinline))
+#endif
+
+// Kernels reading whole aligned vectors around a short buffer, the bytes outside it are masked away
+#if defined(_MSC_VER) && !defined(__clang__)
+#define IMGUI_NO_SANITIZE_ADDRESS __declspec(no_sanitize_address)
+#else
+#define IMGUI_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#endif
+
+#pragma region CPU_FEATURES
+
+typedef int ImCpuFeatureFlags;
+
+enum ImCpuFeatureFlags_
+{
+  ImCpuFeatureFlags_None        = 0,
+  ImCpuFeatureFlags_SSE2        = 1 << 0,
+  ImCpuFeatureFlags_SSE3        = 1 << 1,
+  ImCpuFeatureFlags_SSSE3       = 1 << 2,
+  ImCpuFeatureFlags_SSE4_1      = 1 << 3,
+  ImCpuFeatureFlags_SSE4_2      = 1 << 4,
+  ImCpuFeatureFlags_POPCNT      = 1 << 5,
+  ImCpuFeatureFlags_AVX         = 1 << 6,
+  ImCpuFeatureFlags_AVX2        = 1 << 7,
+  ImCpuFeatureFlags_BMI1        = 1 << 8,
+  ImCpuFeatureFlags_BMI2        = 1 << 9,
+  ImCpuFeatureFlags_AVX512F     = 1 << 10,
+  ImCpuFeatureFlags_AVX512BW    = 1 << 11,
+  ImCpuFeatureFlags_AVX512VBMI2 = 1 << 12,
+  ImCpuFeatureFlags_AVX512VBMI  = 1 << 13,
+};
+
+static void ImCpuid(int leaf, int subleaf, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+  __cpuidex((int*)regs, leaf, subleaf);
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static uint64_t ImXgetbv(unsigned int index)
+{
+#if defined(_MSC_VER)
+  return _xgetbv(index);
+#else
+  unsigned int eax, edx;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+  return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+ImCpuFeatureFlags ImDetectCpuFeatures()
+{
+  ImCpuFeatureFlags flags = ImCpuFeatureFlags_None;
+  unsigned int regs[4] = {}; // eax, ebx, ecx, edx
+
+  ImCpuid(0, 0, regs);
+  const unsigned int max_leaf = regs[0];
+
+  if (max_leaf < 1)
+    return flags;
+
+  ImCpuid(1, 0, regs);
+  const unsigned int leaf1_ecx = regs[2];
+  const unsigned int leaf1_edx = regs[3];
+
+  if (leaf1_edx & (1u << 26)) flags |= ImCpuFeatureFlags_SSE2;
+  if (leaf1_ecx & (1u << 0))  flags |= ImCpuFeatureFlags_SSE3;
+  if (leaf1_ecx & (1u << 9))  flags |= ImCpuFeatureFlags_SSSE3;
+  if (leaf1_ecx & (1u << 19)) flags |= ImCpuFeatureFlags_SSE4_1;
+  if (leaf1_ecx & (1u << 20)) flags |= ImCpuFeatureFlags_SSE4_2;
+  if (leaf1_ecx & (1u << 23)) flags |= ImCpuFeatureFlags_POPCNT;
+
+  // The OS must save the YMM/ZMM state on context switches, otherwise AVX instructions fault
+  const bool os_xsave = (leaf1_ecx & (1u << 27)) != 0;
+  const uint64_t xcr0 = os_xsave ? ImXgetbv(0) : 0;
+  const bool os_ymm = (xcr0 & 0x06) == 0x06; // XMM | YMM
+  const bool os_zmm = (xcr0 & 0xE6) == 0xE6; // XMM | YMM | opmask | ZMM_Hi256 | Hi16_ZMM
+
+  if (os_ymm && (leaf1_ecx & (1u << 28)))
+    flags |= ImCpuFeatureFlags_AVX;
+
+  if (max_leaf < 7)
+    return flags;
+
+  ImCpuid(7, 0, regs);
+  const unsigned int leaf7_ebx = regs[1];
+  const unsigned int leaf7_ecx = regs[2];
+
+  if (leaf7_ebx & (1u << 3)) flags |= ImCpuFeatureFlags_BMI1;
+  if (leaf7_ebx & (1u << 8)) flags |= ImCpuFeatureFlags_BMI2;
+
+  if (os_ymm && (leaf7_ebx & (1u << 5)))
+    flags |= ImCpuFeatureFlags_AVX2;
+
+  if (os_zmm && (leaf7_ebx & (1u << 16)))
+    flags |= ImCpuFeatureFlags_AVX512F;
+
+  if (os_zmm && (leaf7_ebx & (1u << 30)))
+    flags |= ImCpuFeatureFlags_AVX512BW;
+
+  if (os_zmm && (leaf7_ecx & (1u << 1)))
+    flags |= ImCpuFeatureFlags_AVX512VBMI;
+
+  if (os_zmm && (leaf7_ecx & (1u << 6)))
+    flags |= ImCpuFeatureFlags_AVX512VBMI2;
+
+  return flags;
+}
+
+ImCpuFeatureFlags ImGetCpuFeatures()
+{
+  static const ImCpuFeatureFlags flags = ImDetectCpuFeatures();
+  return flags;
+}
+
+bool ImHasCpuFeatures(ImCpuFeatureFlags required)
+{
+  return (ImGetCpuFeatures() & required) == required;
+}
+
+#pragma endregion
+// CPU_FEATURES
+
+#pragma region PREFETCH
+
+// The *_PREFETCH kernels read their prefetch distance, hint and rate from the settings of their ISA.
+// The settings start at the defaults below and are overridden by the profile at IMGUI_PREFETCH_PROFILE_PATH
+// at startup, the benchmark writes that profile in --prefetch_autotune mode.
+
+#ifndef IMGUI_PREFETCH_PROFILE_PATH
+#define IMGUI_PREFETCH_PROFILE_PATH "immemchr_prefetch.ini"
+#endif
+
+#define IMGUI_CACHE_LINE_LENGTH 64
+
+typedef int ImPrefetchHint;
+
+enum ImPrefetchHint_
+{
+  ImPrefetchHint_T0,
+  ImPrefetchHint_T1,
+  ImPrefetchHint_T2,
+  ImPrefetchHint_NTA,
+  ImPrefetchHint_COUNT
+};
+
+typedef int ImMemchrIsa;
+
+enum ImMemchrIsa_
+{
+  ImMemchrIsa_AVX512,
+  ImMemchrIsa_AVX2,
+  ImMemchrIsa_SSE4_2,
+  ImMemchrIsa_SSE,
+  ImMemchrIsa_COUNT
+};
+
+static const char* const ImPrefetchHintNames[ImPrefetchHint_COUNT] = { "T0", "T1", "T2", "NTA" };
+static const char* const ImMemchrIsaNames[ImMemchrIsa_COUNT] = { "AVX512", "AVX2", "SSE4_2", "SSE" };
+
+struct ImPrefetchSettings
+{
+  size_t distance = IMGUI_PREFECTH_LENGTH; // Bytes ahead of the scan pointer, 0 disables prefetching
+  ImPrefetchHint hint = ImPrefetchHint_T0;
+  size_t every_lines = 1;                  // One prefetch per N cache lines scanned, whatever the vector stride
+};
+
+static inline void ImPrefetch(const void* ptr, ImPrefetchHint hint)
+{
+  switch (hint)
+  {
+  case ImPrefetchHint_T1:  _mm_prefetch((const char*)ptr, _MM_HINT_T1); break;
+  case ImPrefetchHint_T2:  _mm_prefetch((const char*)ptr, _MM_HINT_T2); break;
+  case ImPrefetchHint_NTA: _mm_prefetch((const char*)ptr, _MM_HINT_NTA); break;
+  default:                 _mm_prefetch((const char*)ptr, _MM_HINT_T0); break;
+  }
+}
+
+// Issues at most one prefetch per every_lines cache lines and never prefetches past the end of the buffer
+struct ImPrefetcher
+{
+  uintptr_t next = 0; // Scan address that triggers the next prefetch
+  uintptr_t last = 0; // Last scan address whose prefetch target is inside the buffer, 0 when disabled
+  size_t distance = 0;
+  size_t stride = 0;
+  ImPrefetchHint hint = ImPrefetchHint_T0;
+
+  ImPrefetcher() = default;
+
+  ImPrefetcher(const ImPrefetchSettings& settings, const void* begin, const void* end)
+    : next((uintptr_t)begin),
+      distance(settings.distance),
+      stride((settings.every_lines ? settings.every_lines : 1) * IMGUI_CACHE_LINE_LENGTH),
+      hint(settings.hint)
+  {
+    if (distance != 0 && (uintptr_t)end - (uintptr_t)begin > distance)
+      last = (uintptr_t)end - distance;
+  }
+
+  void operator()(const void* ptr)
+  {
+    const uintptr_t address = (uintptr_t)ptr;
+
+    if (address >= next && address <= last)
+    {
+      ImPrefetch((const char*)ptr + distance, hint);
+      next = address + stride;
+    }
+  }
+};
+
+static FILE* ImFileOpen(const char* path, const char* mode)
+{
+#if defined(_MSC_VER)
+  FILE* file = nullptr;
+  return fopen_s(&file, path, mode) == 0 ? file : nullptr;
+#else
+  return fopen(path, mode);
+#endif
+}
+
+// Profile format, one section per ISA, missing keys keep their current value:
+// [Prefetch][AVX2]
+// Distance=2048
+// Hint=T1
+// EveryLines=2
+static bool ImLoadPrefetchProfileInto(const char* path, ImPrefetchSettings* table)
+{
+  FILE* file = ImFileOpen(path, "r");
+
+  if (!file)
+    return false;
+
+  char line[256];
+  ImPrefetchSettings* settings = nullptr;
+
+  while (fgets(line, sizeof(line), file))
+  {
+    line[strcspn(line, "\r\n")] = 0;
+
+    if (strncmp(line, "[Prefetch][", 11) == 0)
+    {
+      settings = nullptr;
+
+      for (int isa = 0; isa < ImMemchrIsa_COUNT; isa++)
+      {
+        const size_t name_length = strlen(ImMemchrIsaNames[isa]);
+
+        if (strncmp(line + 11, ImMemchrIsaNames[isa], name_length) == 0 && line[11 + name_length] == ']')
+          settings = &table[isa];
+      }
+    }
+    else if (settings && strncmp(line, "Distance=", 9) == 0)
+    {
+      settings->distance = (size_t)strtoull(line + 9, nullptr, 10);
+    }
+    else if (settings && strncmp(line, "EveryLines=", 11) == 0)
+    {
+      settings->every_lines = (size_t)strtoull(line + 11, nullptr, 10);
+    }
+    else if (settings && strncmp(line, "Hint=", 5) == 0)
+    {
+      for (int hint = 0; hint < ImPrefetchHint_COUNT; hint++)
+      {
+        if (strcmp(line + 5, ImPrefetchHintNames[hint]) == 0)
+          settings->hint = hint;
+      }
+    }
+  }
+
+  fclose(file);
+  return true;
+}
+
+// Constant-initialized, so the kernels index it without a static-init guard. The profile is applied
+// once during static initialization, before any kernel or dispatcher can run.
+static ImPrefetchSettings ImPrefetchSettingsTable[ImMemchrIsa_COUNT];
+static const bool ImPrefetchProfileLoaded = ImLoadPrefetchProfileInto(IMGUI_PREFETCH_PROFILE_PATH, ImPrefetchSettingsTable);
+
+static inline ImPrefetchSettings* ImGetPrefetchSettingsTable()
+{
+  return ImPrefetchSettingsTable;
+}
+
+static inline ImPrefetchSettings& ImGetPrefetchSettings(ImMemchrIsa isa)
+{
+  return ImPrefetchSettingsTable[isa];
+}
+
+bool ImLoadPrefetchProfile(const char* path)
+{
+  return ImLoadPrefetchProfileInto(path, ImGetPrefetchSettingsTable());
+}
+
+bool ImSavePrefetchProfile(const char* path)
+{
+  FILE* file = ImFileOpen(path, "w");
+
+  if (!file)
+    return false;
+
+  const ImPrefetchSettings* table = ImGetPrefetchSettingsTable();
+
+  for (int isa = 0; isa < ImMemchrIsa_COUNT; isa++)
+  {
+    fprintf(file, "[Prefetch][%s]\n", ImMemchrIsaNames[isa]);
+    fprintf(file, "Distance=%llu\n", (unsigned long long)table[isa].distance);
+    fprintf(file, "Hint=%s\n", ImPrefetchHintNames[table[isa].hint]);
+    fprintf(file, "EveryLines=%llu\n\n", (unsigned long long)table[isa].every_lines);
+  }
+
+  return fclose(file) == 0;
+}
+
+#pragma endregion
+// PREFETCH
+
+// tzcnt decodes as bsf on pre-BMI hosts, so the baseline kernels use bsf semantics directly
+static inline unsigned int ImCountTrailingZeros32(uint32_t mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return (unsigned int)index;
+#else
+  return (unsigned int)__builtin_ctz(mask);
+#endif
+}
+
+// Software popcount for the SSE2 baseline, which cannot assume the POPCNT instruction
+static inline unsigned int ImCountSetBits64(uint64_t v)
+{
+  v = v - ((v >> 1) & 0x5555555555555555ull);
+  v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+  v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+  return (unsigned int)((v * 0x0101010101010101ull) >> 56);
+}
+
+static inline unsigned int ImCountTrailingZeros64(uint64_t mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, mask);
+  return (unsigned int)index;
+#else
+  return (unsigned int)__builtin_ctzll(mask);
+#endif
+}
+
+// Index of the k-th (0-based) set bit, k must be below the number of set bits
+static inline unsigned int ImSelectSetBit64(uint64_t mask, size_t k)
+{
+  for (; k; k--)
+    mask &= mask - 1;
+
+  return ImCountTrailingZeros64(mask);
+}
+
+#pragma region KERNEL
+
+// Every ImMemchr kernel is ImMemchrKernel<Isa, Unroll, PrefetchPolicy>. The ISA traits wrap the load,
+// compare, mask and tzcnt steps. Each trait also carries the Memchr entry point that instantiates the
+// generic body under its own target attribute: GCC and Clang only inline the intrinsics into a function
+// compiled for that ISA, IMGUI_FLATTEN pulls the whole body into it. MSVC needs neither. The body only
+// passes pointers, bytes and masks to the traits, vectors never cross a call left out of line in debug builds.
+
+typedef const void* (*ImMemchrFunc)(const void* buf, int val, size_t count);
+
+static const ImCpuFeatureFlags ImMemchrRequiredAVX512       = ImCpuFeatureFlags_AVX512F | ImCpuFeatureFlags_AVX512BW | ImCpuFeatureFlags_BMI1 | ImCpuFeatureFlags_POPCNT;
+static const ImCpuFeatureFlags ImMemchrRequiredAVX512_VBMI2 = ImMemchrRequiredAVX512 | ImCpuFeatureFlags_AVX512VBMI2;
+static const ImCpuFeatureFlags ImMemchrRequiredAVX512_VBMI  = ImMemchrRequiredAVX512 | ImCpuFeatureFlags_AVX512VBMI;
+static const ImCpuFeatureFlags ImMemchrRequiredAVX2         = ImCpuFeatureFlags_AVX2 | ImCpuFeatureFlags_BMI1 | ImCpuFeatureFlags_POPCNT;
+static const ImCpuFeatureFlags ImMemchrRequiredSSE4_2       = ImCpuFeatureFlags_SSE4_2 | ImCpuFeatureFlags_POPCNT;
+static const ImCpuFeatureFlags ImMemchrRequiredSSSE3        = ImCpuFeatureFlags_SSSE3;
+static const ImCpuFeatureFlags ImMemchrRequiredSSE2         = ImCpuFeatureFlags_SSE2;
+
+struct ImPrefetchNone
+{
+  static constexpr const char* SUFFIX = "";
+
+  ImPrefetchNone(ImMemchrIsa, const void*, const void*) {}
+  void operator()(const void*) {}
+};
+
+// Distance, hint and rate come from the ImPrefetchSettings of the ISA
+struct ImPrefetchTuned : ImPrefetcher
+{
+  static constexpr const char* SUFFIX = "_PREFETCH";
+
+  ImPrefetchTuned(ImMemchrIsa isa, const void* begin, const void* end)
+    : ImPrefetcher(ImGetPrefetchSettings(isa), begin, end)
+  {
+  }
+};
+
+template <class Isa, int Unroll, class PrefetchPolicy>
+const void* ImMemchrKernelBody(const void* buf, int val, size_t count);
+
+// The fewer than SIMD_LENGTH bytes [ptr, end) left after the vector loops of a family kernel, as up to two
+// vectors and their match masks. A buffer [begin, end) of at least one vector ends with an unaligned vector
+// ending exactly at end, its lanes before ptr were already scanned and are masked off. Shorter buffers read the
+// one or two aligned vectors holding them, which never cross a page, and mask away the bytes outside the buffer.
+struct ImMemchrTail
+{
+  const unsigned char* blocks[2];
+  uint64_t masks[2];
+  int count;
+};
+
+// Each trait wraps it as ScanTail under its own target attribute, so the compares inline into the kernels
+template <class Isa>
+static inline ImMemchrTail ImMemchrScanTail(const unsigned char* begin, const unsigned char* ptr, const unsigned char* end, unsigned char ch)
+{
+  const size_t SIMD_LENGTH = Isa::SIMD_LENGTH;
+  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+
+  ImMemchrTail tail = {};
+
+  if (ptr >= end)
+    return tail;
+
+  if ((size_t)(end - begin) >= SIMD_LENGTH)
+  {
+    const unsigned char* block = end - SIMD_LENGTH;
+
+    tail.blocks[0] = block;
+    tail.masks[0] = (uint64_t)Isa::CompareUnaligned(block, ch) & (~0ull << (ptr - block));
+    tail.count = 1;
+    return tail;
+  }
+
+  const unsigned char* block = (const unsigned char*)((uintptr_t)ptr & ~(uintptr_t)SIMD_LENGTH_MASK);
+  const size_t first = (size_t)(ptr - block);
+  const size_t last = first + (size_t)(end - ptr);
+
+  tail.blocks[0] = block;
+  tail.masks[0] = (uint64_t)Isa::CompareAligned(block, ch) & (~0ull << first) & (last < 64 ? (1ull << last) - 1 : ~0ull);
+  tail.count = 1;
+
+  if (last > SIMD_LENGTH)
+  {
+    tail.blocks[1] = block + SIMD_LENGTH;
+    tail.masks[1] = (uint64_t)Isa::CompareAligned(block + SIMD_LENGTH, ch) & ((1ull << (last - SIMD_LENGTH)) - 1);
+    tail.count = 2;
+  }
+
+  return tail;
+}
+
+struct ImSimdAVX512
+{
+  using Vector = __m512i;
+  using Mask = uint64_t;
+
+  static constexpr size_t SIMD_LENGTH = 64;
+  static constexpr ImMemchrIsa ISA = ImMemchrIsa_AVX512;
+  static constexpr ImCpuFeatureFlags REQUIRED = ImMemchrRequiredAVX512;
+  static constexpr const char* NAME = "AVX512";
+  static constexpr bool MASKED_LOAD = false;
+
+  IMGUI_TARGET_AVX512 static inline Vector Broadcast(unsigned char ch)           { return _mm512_set1_epi8((char)ch); }
+  IMGUI_TARGET_AVX512 static inline Vector LoadAligned(const unsigned char* ptr)   { return _mm512_load_si512((const __m512i*)ptr); }
+  IMGUI_TARGET_AVX512 static inline Vector LoadUnaligned(const unsigned char* ptr) { return _mm512_loadu_si512((const __m512i*)ptr); }
+  IMGUI_TARGET_AVX512 static inline Mask Compare(Vector chunk, Vector target)     { return _mm512_cmpeq_epi8_mask(chunk, target); }
+  IMGUI_TARGET_AVX512 static inline Mask CompareAligned(const unsigned char* ptr, unsigned char ch)   { return Compare(LoadAligned(ptr), Broadcast(ch)); }
+  IMGUI_TARGET_AVX512 static inline Mask CompareUnaligned(const unsigned char* ptr, unsigned char ch) { return Compare(LoadUnaligned(ptr), Broadcast(ch)); }
+  IMGUI_TARGET_AVX512 static inline Mask Combine(Mask a, Mask b)                  { return _kor_mask64(a, b); }
+  IMGUI_TARGET_AVX512 static inline bool AnySet(Mask mask)                        { return !_kortestz_mask64_u8(mask, mask); }
+  IMGUI_TARGET_AVX512 static inline unsigned int FirstSet(Mask mask)              { return (unsigned int)_tzcnt_u64(mask); }
+
+  // Compares bytes [first, last) of the 64 at ptr, the bytes outside the range are neither loaded nor matched
+  IMGUI_TARGET_AVX512 static inline Mask CompareRange(const unsigned char* ptr, size_t first, size_t last, unsigned char ch)
+  {
+    const __mmask64 range = (~0ull << first) & (last ? ~0ull >> (SIMD_LENGTH - last) : 0);
+    return _mm512_mask_cmpeq_epi8_mask(range, _mm512_maskz_loadu_epi8(range, ptr), Broadcast(ch));
+  }
+
+  IMGUI_TARGET_AVX512 IMGUI_FLATTEN IMGUI_NO_SANITIZE_ADDRESS static ImMemchrTail ScanTail(const unsigned char* begin, const unsigned char* ptr, const unsigned char* end, unsigned char ch)
+  {
+    return ImMemchrScanTail<ImSimdAVX512>(begin, ptr, end, ch);
+  }
+
+  template <int Unroll, class PrefetchPolicy>
+  IMGUI_TARGET_AVX512 IMGUI_FLATTEN IMGUI_NO_SANITIZE_ADDRESS static const void* Memchr(const void* buf, int val, size_t count)
+  {
+    return ImMemchrKernelBody<ImSimdAVX512, Unroll, PrefetchPolicy>(buf, val, count);
+  }
+};
+
+// AVX-512 with the head and the tail read by masked loads, the masked out bytes are never touched
+struct ImSimdAVX512_MASKED : ImSimdAVX512
+{
+  static constexpr const char* NAME = "AVX512_MASKED";
+  static constexpr bool MASKED_LOAD = true;
+
+  template <int Unroll, class PrefetchPolicy>
+  IMGUI_TARGET_AVX512 IMGUI_FLATTEN static const void* Memchr(const void* buf, int val, size_t count)
+  {
+    return ImMemchrKernelBody<ImSimdAVX512_MASKED, Unroll, PrefetchPolicy>(buf, val, count);
+  }
+};
+
+struct ImSimdAVX2
+{
+  using Vector = __m256i;
+  using Mask = uint32_t;
+
+  static constexpr size_t SIMD_LENGTH = 32;
+  static constexpr ImMemchrIsa ISA = ImMemchrIsa_AVX2;
+  static constexpr ImCpuFeatureFlags REQUIRED = ImMemchrRequiredAVX2;
+  static constexpr const char* NAME = "AVX2";
+  static constexpr bool MASKED_LOAD = false;
+
+  IMGUI_TARGET_AVX2 static inline Vector Broadcast(unsigned char ch)           { return _mm256_set1_epi8((char)ch); }
+  IMGUI_TARGET_AVX2 static inline Vector LoadAligned(const unsigned char* ptr)   { return _mm256_load_si256((const __m256i*)ptr); }
+  IMGUI_TARGET_AVX2 static inline Vector LoadUnaligned(const unsigned char* ptr) { return _mm256_lddqu_si256((const __m256i*)ptr); }
+  IMGUI_TARGET_AVX2 static inline Mask Compare(Vector chunk, Vector target)     { return (Mask)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target)); }
+  IMGUI_TARGET_AVX2 static inline Mask CompareAligned(const unsigned char* ptr, unsigned char ch)   { return Compare(LoadAligned(ptr), Broadcast(ch)); }
+  IMGUI_TARGET_AVX2 static inline Mask CompareUnaligned(const unsigned char* ptr, unsigned char ch) { return Compare(LoadUnaligned(ptr), Broadcast(ch)); }
+  IMGUI_TARGET_AVX2 static inline Mask Combine(Mask a, Mask b)                  { return a | b; }
+  IMGUI_TARGET_AVX2 static inline bool AnySet(Mask mask)                        { return mask != 0; }
+  IMGUI_TARGET_AVX2 static inline unsigned int FirstSet(Mask mask)              { return _tzcnt_u32(mask); }
+
+  IMGUI_TARGET_AVX2 IMGUI_FLATTEN IMGUI_NO_SANITIZE_ADDRESS static ImMemchrTail ScanTail(const unsigned char* begin, const unsigned char* ptr, const unsigned char* end, unsigned char ch)
+  {
+    return ImMemchrScanTail<ImSimdAVX2>(begin, ptr, end, ch);
+  }
+
+  template <int Unroll, class PrefetchPolicy>
+  IMGUI_TARGET_AVX2 IMGUI_FLATTEN IMGUI_NO_SANITIZE_ADDRESS static const void* Memchr(const void* buf, int val, size_t count)
+  {
+    return ImMemchrKernelBody<ImSimdAVX2, Unroll, PrefetchPolicy>(buf, val, count);
+  }
+};
+
+// Compares with pcmpestrm and explicit lengths, so a NUL byte in the buffer does not end the compare
+struct ImSimdSSE4_2
+{
+  using Vector = __m128i;
+  using Mask = uint32_t;
+
+  static constexpr size_t SIMD_LENGTH = 16;
+  static constexpr ImMemchrIsa ISA = ImMemchrIsa_SSE4_2;
+  static constexpr ImCpuFeatureFlags REQUIRED = ImMemchrRequiredSSE4_2;
+  static constexpr const char* NAME = "SSE4_2";
+  static constexpr bool MASKED_LOAD = false;
+
+  IMGUI_TARGET_SSE4_2 static inline Vector Broadcast(unsigned char ch)           { return _mm_set1_epi8((char)ch); }
+  IMGUI_TARGET_SSE4_2 static inline Vector LoadAligned(const unsigned char* ptr)   { return _mm_load_si128((const __m128i*)ptr); }
+  IMGUI_TARGET_SSE4_2 static inline Vector LoadUnaligned(const unsigned char* ptr) { return _mm_lddqu_si128((const __m128i*)ptr); }
+  IMGUI_TARGET_SSE4_2 static inline Mask Compare(Vector chunk, Vector target)     { return (Mask)_mm_cvtsi128_si32(_mm_cmpestrm(target, 16, chunk, 16, _SIDD_CMP_EQUAL_EACH | _SIDD_BIT_MASK)); }
+  IMGUI_TARGET_SSE4_2 static inline Mask CompareAligned(const unsigned char* ptr, unsigned char ch)   { return Compare(LoadAligned(ptr), Broadcast(ch)); }
+  IMGUI_TARGET_SSE4_2 static inline Mask CompareUnaligned(const unsigned char* ptr, unsigned char ch) { return Compare(LoadUnaligned(ptr), Broadcast(ch)); }
+  IMGUI_TARGET_SSE4_2 static inline Mask Combine(Mask a, Mask b)                  { return a | b; }
+  IMGUI_TARGET_SSE4_2 static inline bool AnySet(Mask mask)                        { return mask != 0; }
+  IMGUI_TARGET_SSE4_2 static inline unsigned int FirstSet(Mask mask)              { return ImCountTrailingZeros32(mask); }
+
+  IMGUI_TARGET_SSE4_2 IMGUI_FLATTEN IMGUI_NO_SANITIZE_ADDRESS static ImMemchrTail ScanTail(const unsigned char* begin, const unsigned char* ptr, const unsigned char* end, unsigned char ch)
+  {
+    return ImMemchrScanTail<ImSimdSSE4_2>(begin, ptr, end, ch);
+  }
+
+  template <int Unroll, class PrefetchPolicy>
+  IMGUI_TARGET_SSE4_2 IMGUI_FLATTEN IMGUI_NO_SANITIZE_ADDRESS static const void* Memchr(const void* buf, int val, size_t count)
+  {
+    return ImMemchrKernelBody<ImSimdSSE4_2, Unroll, PrefetchPolicy>(buf, val, count);
+  }
+};
+
+struct ImSimdSSE2
+{
+  using Vector = __m128i;
+  using Mask = uint32_t;
+
+  static constexpr size_t SIMD_LENGTH = 16;
+  static constexpr ImMemchrIsa ISA = ImMemchrIsa_SSE;
+  static constexpr ImCpuFeatureFlags REQUIRED = ImMemchrRequiredSSE2;
+  static constexpr const char* NAME = "SSE";
+  static constexpr bool MASKED_LOAD = false;
+
+  IMGUI_TARGET_SSE2 static inline Vector Broadcast(unsigned char ch)           { return _mm_set1_epi8((char)ch); }
+  IMGUI_TARGET_SSE2 static inline Vector LoadAligned(const unsigned char* ptr)   { return _mm_load_si128((const __m128i*)ptr); }
+  IMGUI_TARGET_SSE2 static inline Vector LoadUnaligned(const unsigned char* ptr) { return _mm_loadu_si128((const __m128i*)ptr); }
+  IMGUI_TARGET_SSE2 static inline Mask Compare(Vector chunk, Vector target)     { return (Mask)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)); }
+  IMGUI_TARGET_SSE2 static inline Mask CompareAligned(const unsigned char* ptr, unsigned char ch)   { return Compare(LoadAligned(ptr), Broadcast(ch)); }
+  IMGUI_TARGET_SSE2 static inline Mask CompareUnaligned(const unsigned char* ptr, unsigned char ch) { return Compare(LoadUnaligned(ptr), Broadcast(ch)); }
+  IMGUI_TARGET_SSE2 static inline Mask Combine(Mask a, Mask b)                  { return a | b; }
+  IMGUI_TARGET_SSE2 static inline bool AnySet(Mask mask)                        { return mask != 0; }
+  IMGUI_TARGET_SSE2 static inline unsigned int FirstSet(Mask mask)              { return ImCountTrailingZeros32(mask); }
+
+  IMGUI_TARGET_SSE2 IMGUI_FLATTEN IMGUI_NO_SANITIZE_ADDRESS static ImMemchrTail ScanTail(const unsigned char* begin, const unsigned char* ptr, const unsigned char* end, unsigned char ch)
+  {
+    return ImMemchrScanTail<ImSimdSSE2>(begin, ptr, end, ch);
+  }
+
+  template <int Unroll, class PrefetchPolicy>
+  IMGUI_TARGET_SSE2 IMGUI_FLATTEN IMGUI_NO_SANITIZE_ADDRESS static const void* Memchr(const void* buf, int val, size_t count)
+  {
+    return ImMemchrKernelBody<ImSimdSSE2, Unroll, PrefetchPolicy>(buf, val, count);
+  }
+};
+
+// Unaligned head, then Unroll aligned vectors per iteration whose masks are combined into a single branch,
+// then single aligned vectors and an unaligned vector overlapping the last one. Buffers shorter than a vector
+// are read with aligned loads and masked. With MASKED_LOAD the head and the tail are masked loads of the
+// aligned vectors holding them instead. No kernel has a scalar loop.
+template <class Isa, int Unroll, class PrefetchPolicy>
+const void* ImMemchrKernelBody(const void* buf, int val, size_t count)
+{
+  static_assert(Unroll >= 1, "Unroll must be at least 1");
+
+  using Mask = typename Isa::Mask;
+
+  const size_t SIMD_LENGTH = Isa::SIMD_LENGTH;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * Unroll;
+  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+
+  const unsigned char* ptr = (const unsigned char*)buf;
+  const unsigned char* end = ptr + count;
+  const unsigned char ch = (const unsigned char)val;
+  PrefetchPolicy prefetcher(Isa::ISA, ptr, end);
+
+  if constexpr (Isa::MASKED_LOAD)
+  {
+    const unsigned char* block = (const unsigned char*)((uintptr_t)ptr & ~(uintptr_t)SIMD_LENGTH_MASK);
+    const size_t first = (size_t)(ptr - block);
+    const size_t last = count < SIMD_LENGTH - first ? first + count : SIMD_LENGTH;
+
+    Mask mask = Isa::CompareRange(block, first, last, ch);
+
+    if (Isa::AnySet(mask))
+      return (const void*)(block + Isa::FirstSet(mask));
+
+    if (first + count <= SIMD_LENGTH)
+      return nullptr;
+
+    ptr = block + SIMD_LENGTH;
+  }
+  else if (count < SIMD_LENGTH)
+  {
+    // Shorter than a vector: aligned loads never cross a page, the bytes outside the buffer are masked away
+    if (count == 0)
+      return nullptr;
+
+    const unsigned char* block = (const unsigned char*)((uintptr_t)ptr & ~(uintptr_t)SIMD_LENGTH_MASK);
+    const size_t first = (size_t)(ptr - block);
+
+    Mask mask = (Mask)(Isa::CompareAligned(block, ch) >> first) & (((Mask)1 << count) - 1);
+
+    if (Isa::AnySet(mask))
+      return (const void*)(ptr + Isa::FirstSet(mask));
+
+    if (first + count <= SIMD_LENGTH)
+      return nullptr;
+
+    block += SIMD_LENGTH;
+    mask = Isa::CompareAligned(block, ch) & (((Mask)1 << (first + count - SIMD_LENGTH)) - 1);
+
+    if (Isa::AnySet(mask))
+      return (const void*)(block + Isa::FirstSet(mask));
+
+    return nullptr;
+  }
+  else if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+  {
+    Mask mask = Isa::CompareUnaligned(ptr, ch);
+
+    if (Isa::AnySet(mask))
+      return (const void*)(ptr + Isa::FirstSet(mask));
+
+    ptr = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~(uintptr_t)SIMD_LENGTH_MASK);
+  }
+
+  if constexpr (Unroll > 1)
+  {
+    for (; (size_t)(end - ptr) >= SIMD_UNROLLED_LENGTH; ptr += SIMD_UNROLLED_LENGTH)
+    {
+      Mask masks[Unroll];
+
+      for (int i = 0; i < Unroll; i++)
+        masks[i] = Isa::CompareAligned(ptr + SIMD_LENGTH * i, ch);
+
+      Mask any = masks[0];
+
+      for (int i = 1; i < Unroll; i++)
+        any = Isa::Combine(any, masks[i]);
+
+      if (Isa::AnySet(any))
+      {
+        for (int i = 0; i < Unroll; i++)
+        {
+          if (Isa::AnySet(masks[i]))
+            return (const void*)(ptr + SIMD_LENGTH * i + Isa::FirstSet(masks[i]));
+        }
+      }
+
+      prefetcher(ptr);
+    }
+  }
+
+  for (; (size_t)(end - ptr) >= SIMD_LENGTH; ptr += SIMD_LENGTH)
+  {
+    Mask mask = Isa::CompareAligned(ptr, ch);
+
+    if (Isa::AnySet(mask))
+      return (const void*)(ptr + Isa::FirstSet(mask));
+
+    prefetcher(ptr);
+  }
+
+  if constexpr (Isa::MASKED_LOAD)
+  {
+    if (ptr < end)
+    {
+      Mask mask = Isa::CompareRange(ptr, 0, (size_t)(end - ptr), ch);
+
+      if (Isa::AnySet(mask))
+        return (const void*)(ptr + Isa::FirstSet(mask));
+    }
+  }
+  else if (ptr < end)
+  {
+    // The last vector ends exactly at end, its bytes before ptr were already compared without a match
+    Mask mask = Isa::CompareUnaligned(end - SIMD_LENGTH, ch);
+
+    if (Isa::AnySet(mask))
+      return (const void*)(end - SIMD_LENGTH + Isa::FirstSet(mask));
+  }
+
+  return nullptr;
+}
+
+template <class Isa, int Unroll, class PrefetchPolicy>
+constexpr ImMemchrFunc ImMemchrKernel = &Isa::template Memchr<Unroll, PrefetchPolicy>;
+
+// The original hand-written kernels, kept as names of their instantiations
+constexpr ImMemchrFunc ImMemchrAVX512_PREFETCH        = ImMemchrKernel<ImSimdAVX512, 1, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrAVX512                 = ImMemchrKernel<ImSimdAVX512, 1, ImPrefetchNone>;
+
+constexpr ImMemchrFunc ImMemchrAVX512_MASKED_UNROLL4_PREFETCH = ImMemchrKernel<ImSimdAVX512_MASKED, 4, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrAVX512_MASKED_UNROLL4          = ImMemchrKernel<ImSimdAVX512_MASKED, 4, ImPrefetchNone>;
+constexpr ImMemchrFunc ImMemchrAVX512_MASKED_UNROLL2_PREFETCH = ImMemchrKernel<ImSimdAVX512_MASKED, 2, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrAVX512_MASKED_UNROLL2          = ImMemchrKernel<ImSimdAVX512_MASKED, 2, ImPrefetchNone>;
+constexpr ImMemchrFunc ImMemchrAVX512_MASKED_PREFETCH         = ImMemchrKernel<ImSimdAVX512_MASKED, 1, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrAVX512_MASKED                  = ImMemchrKernel<ImSimdAVX512_MASKED, 1, ImPrefetchNone>;
+
+constexpr ImMemchrFunc ImMemchrAVX2_UNROLL_PREFETCH   = ImMemchrKernel<ImSimdAVX2, 4, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrAVX2_UNROLL            = ImMemchrKernel<ImSimdAVX2, 4, ImPrefetchNone>;
+constexpr ImMemchrFunc ImMemchrAVX2_PREFETCH          = ImMemchrKernel<ImSimdAVX2, 1, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrAVX2                   = ImMemchrKernel<ImSimdAVX2, 1, ImPrefetchNone>;
+
+constexpr ImMemchrFunc ImMemchrSSE4_2_UNROLL_PREFETCH = ImMemchrKernel<ImSimdSSE4_2, 2, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrSSE4_2_UNROLL          = ImMemchrKernel<ImSimdSSE4_2, 2, ImPrefetchNone>;
+constexpr ImMemchrFunc ImMemchrSSE4_2_PREFETCH        = ImMemchrKernel<ImSimdSSE4_2, 1, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrSSE4_2                 = ImMemchrKernel<ImSimdSSE4_2, 1, ImPrefetchNone>;
+
+constexpr ImMemchrFunc ImMemchrSSE_UNROLL_PREFETCH    = ImMemchrKernel<ImSimdSSE2, 4, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrSSE_UNROLL             = ImMemchrKernel<ImSimdSSE2, 4, ImPrefetchNone>;
+constexpr ImMemchrFunc ImMemchrSSE_PREFETCH           = ImMemchrKernel<ImSimdSSE2, 1, ImPrefetchTuned>;
+constexpr ImMemchrFunc ImMemchrSSE                    = ImMemchrKernel<ImSimdSSE2, 1, ImPrefetchNone>;
+
+#pragma endregion
+// KERNEL
+
+const void* ImMemchrCSTD(const void* buf, int val, size_t count)
+{
+  return memchr(buf, val, count);
+}
+
+
+#pragma region DISPATCH
+
+struct ImMemchrKernelInfo
+{
+  const char* name;
+  ImMemchrFunc func;
+  ImCpuFeatureFlags required;
+};
+
+// Every kernel by name and required features, in no particular order
+static const ImMemchrKernelInfo ImMemchrKernels[] =
+{
+  { "AVX512_PREFETCH",       ImMemchrAVX512_PREFETCH,       ImMemchrRequiredAVX512 },
+  { "AVX512",                ImMemchrAVX512,                ImMemchrRequiredAVX512 },
+  { "AVX512_MASKED_UNROLL4_PREFETCH", ImMemchrAVX512_MASKED_UNROLL4_PREFETCH, ImMemchrRequiredAVX512 },
+  { "AVX512_MASKED_UNROLL4", ImMemchrAVX512_MASKED_UNROLL4, ImMemchrRequiredAVX512 },
+  { "AVX512_MASKED_UNROLL2_PREFETCH", ImMemchrAVX512_MASKED_UNROLL2_PREFETCH, ImMemchrRequiredAVX512 },
+  { "AVX512_MASKED_UNROLL2", ImMemchrAVX512_MASKED_UNROLL2, ImMemchrRequiredAVX512 },
+  { "AVX512_MASKED_PREFETCH",ImMemchrAVX512_MASKED_PREFETCH,ImMemchrRequiredAVX512 },
+  { "AVX512_MASKED",         ImMemchrAVX512_MASKED,         ImMemchrRequiredAVX512 },
+  { "AVX2_UNROLL_PREFETCH",  ImMemchrAVX2_UNROLL_PREFETCH,  ImMemchrRequiredAVX2 },
+  { "AVX2_UNROLL",           ImMemchrAVX2_UNROLL,           ImMemchrRequiredAVX2 },
+  { "AVX2_PREFETCH",         ImMemchrAVX2_PREFETCH,         ImMemchrRequiredAVX2 },
+  { "AVX2",                  ImMemchrAVX2,                  ImMemchrRequiredAVX2 },
+  { "SSE4_2_UNROLL_PREFETCH",ImMemchrSSE4_2_UNROLL_PREFETCH,ImMemchrRequiredSSE4_2 },
+  { "SSE4_2_UNROLL",         ImMemchrSSE4_2_UNROLL,         ImMemchrRequiredSSE4_2 },
+  { "SSE4_2_PREFETCH",       ImMemchrSSE4_2_PREFETCH,       ImMemchrRequiredSSE4_2 },
+  { "SSE4_2",                ImMemchrSSE4_2,                ImMemchrRequiredSSE4_2 },
+  { "SSE_UNROLL_PREFETCH",   ImMemchrSSE_UNROLL_PREFETCH,   ImMemchrRequiredSSE2 },
+  { "SSE_UNROLL",            ImMemchrSSE_UNROLL,            ImMemchrRequiredSSE2 },
+  { "SSE_PREFETCH",          ImMemchrSSE_PREFETCH,          ImMemchrRequiredSSE2 },
+  { "SSE",                   ImMemchrSSE,                   ImMemchrRequiredSSE2 },
+  { "CSTD",                  ImMemchrCSTD,                  ImCpuFeatureFlags_None },
+};
+
+// Ordered from the most to the least preferred kernel, the dispatcher binds the first supported one and
+// falls back to CSTD
+static const ImMemchrFunc ImMemchrPreferred[] =
+{
+  ImMemchrAVX512,
+  ImMemchrAVX2_UNROLL,
+  ImMemchrSSE_UNROLL,
+};
+
+const ImMemchrKernelInfo* ImMemchrFindKernel(ImMemchrFunc func)
+{
+  for (const ImMemchrKernelInfo& kernel : ImMemchrKernels)
+  {
+    if (kernel.func == func)
+      return &kernel;
+  }
+
+  return nullptr;
+}
+
+bool ImMemchrIsSupported(ImMemchrFunc func)
+{
+  const ImMemchrKernelInfo* kernel = ImMemchrFindKernel(func);
+  return kernel == nullptr || ImHasCpuFeatures(kernel->required);
+}
+
+const ImMemchrKernelInfo& ImMemchrSelectKernel()
+{
+  for (ImMemchrFunc func : ImMemchrPreferred)
+  {
+    if (ImMemchrIsSupported(func))
+      return *ImMemchrFindKernel(func);
+  }
+
+  return *ImMemchrFindKernel(ImMemchrCSTD);
+}
+
+const void* ImMemchrResolve(const void* buf, int val, size_t count);
+
+// Starts at the resolver, which rebinds it to the selected kernel on the first call
+static std::atomic<ImMemchrFunc> ImMemchrImpl{ ImMemchrResolve };
+
+const void* ImMemchrResolve(const void* buf, int val, size_t count)
+{
+  ImMemchrFunc func = ImMemchrSelectKernel().func;
+  ImMemchrImpl.store(func, std::memory_order_relaxed);
+  return func(buf, val, count);
+}
+
+const void* ImMemchr(const void* buf, int val, size_t count)
+{
+  return ImMemchrImpl.load(std::memory_order_relaxed)(buf, val, count);
+}
+
+#pragma endregion
+// DISPATCH
+
+#pragma region ALL_MATCHES
+
+// Streaming "find all" kernels. The match bitmask of a block is kept between hits and successive
+// offsets are extracted with tzcnt/blsr, instead of restarting a memchr after every match.
+// The callback receives the offset of each match from buf and may return false to stop the scan.
+// Every kernel returns the number of matches passed to the callback.
+
+template <class Callback>
+static inline bool ImMemchrAllEmit(Callback& callback, size_t offset)
+{
+  if constexpr (std::is_void_v<std::invoke_result_t<Callback&, size_t>>)
+  {
+    callback(offset);
+    return true;
+  }
+  else
+  {
+    return callback(offset);
+  }
+}
+
+template <class Callback>
+IMGUI_TARGET_AVX512 IMGUI_NO_SANITIZE_ADDRESS
+size_t ImMemchrAllAVX512(const void* buf, int val, size_t count, Callback&& callback)
+{
+  const size_t SIMD_LENGTH = 64;
+  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+
+  const unsigned char* begin = (const unsigned char*)buf;
+  const unsigned char* ptr = begin;
+  const unsigned char* end = ptr + count;
+  const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char ch = (const unsigned char)val;
+  size_t found = 0;
+
+  if (count >= SIMD_LENGTH)
+  {
+    const __m512i target = _mm512_set1_epi8(ch);
+
+    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+    {
+      const unsigned char* aligned = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      __m512i chunk = _mm512_loadu_si512((const __m512i*)ptr);
+      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target) & ((1ull << (aligned - ptr)) - 1);
+
+      for (; mask; mask = _blsr_u64(mask), found++)
+      {
+        if (!ImMemchrAllEmit(callback, size_t(ptr - begin) + _tzcnt_u64(mask)))
+          return found + 1;
+      }
+
+      ptr = aligned;
+    }
+
+    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    {
+      __m512i chunk = _mm512_load_si512((const __m512i*)ptr);
+      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target);
+
+      for (; mask; mask = _blsr_u64(mask), found++)
+      {
+        if (!ImMemchrAllEmit(callback, size_t(ptr - begin) + _tzcnt_u64(mask)))
+          return found + 1;
+      }
+    }
+  }
+
+  const ImMemchrTail tail = ImSimdAVX512::ScanTail(begin, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
+  {
+    for (uint64_t mask = tail.masks[i]; mask; mask = _blsr_u64(mask), found++)
+    {
+      if (!ImMemchrAllEmit(callback, size_t(tail.blocks[i] + _tzcnt_u64(mask) - begin)))
+        return found + 1;
+    }
+  }
+
+  return found;
+}
+
+template <class Callback>
+IMGUI_TARGET_AVX2 IMGUI_NO_SANITIZE_ADDRESS
+size_t ImMemchrAllAVX2(const void* buf, int val, size_t count, Callback&& callback)
+{
+  const size_t SIMD_LENGTH = 32;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * 2;
+  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+
+  const unsigned char* begin = (const unsigned char*)buf;
+  const unsigned char* ptr = begin;
+  const unsigned char* end = ptr + count;
+  const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
+  const unsigned char ch = (const unsigned char)val;
+  size_t found = 0;
+
+  if (count >= SIMD_LENGTH)
+  {
+    const __m256i target = _mm256_set1_epi8(ch);
+
+    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+    {
+      const unsigned char* aligned = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      __m256i chunk = _mm256_lddqu_si256((const __m256i*)ptr);
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target)) & ((1u << (aligned - ptr)) - 1);
+
+      for (; mask; mask = _blsr_u32(mask), found++)
+      {
+        if (!ImMemchrAllEmit(callback, size_t(ptr - begin) + _tzcnt_u32(mask)))
+          return found + 1;
+      }
+
+      ptr = aligned;
+    }
+
+    // Two vectors are merged into one 64-bit mask, so a line of up to 64 bytes costs a single branch
+    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
+    {
+      __m256i chunk1 = _mm256_load_si256((const __m256i*)ptr);
+      __m256i chunk2 = _mm256_load_si256((const __m256i*)(ptr + SIMD_LENGTH));
 
-#define IMGUI_PREFECTH_LENGTH 1024
+      uint32_t mask1 = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk1, target));
+      uint32_t mask2 = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk2, target));
+      uint64_t mask = ((uint64_t)mask2 << 32) | mask1;
+
+      for (; mask; mask = _blsr_u64(mask), found++)
+      {
+        if (!ImMemchrAllEmit(callback, size_t(ptr - begin) + _tzcnt_u64(mask)))
+          return found + 1;
+      }
+    }
+
+    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    {
+      __m256i chunk = _mm256_load_si256((const __m256i*)ptr);
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+
+      for (; mask; mask = _blsr_u32(mask), found++)
+      {
+        if (!ImMemchrAllEmit(callback, size_t(ptr - begin) + _tzcnt_u32(mask)))
+          return found + 1;
+      }
+    }
+  }
+
+  const ImMemchrTail tail = ImSimdAVX2::ScanTail(begin, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
+  {
+    for (uint64_t mask = tail.masks[i]; mask; mask = _blsr_u64(mask), found++)
+    {
+      if (!ImMemchrAllEmit(callback, size_t(tail.blocks[i] + _tzcnt_u64(mask) - begin)))
+        return found + 1;
+    }
+  }
+
+  return found;
+}
+
+template <class Callback>
+IMGUI_TARGET_SSE2 IMGUI_NO_SANITIZE_ADDRESS
+size_t ImMemchrAllSSE(const void* buf, int val, size_t count, Callback&& callback)
+{
+  const size_t SIMD_LENGTH = 16;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * 4;
+  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+
+  const unsigned char* begin = (const unsigned char*)buf;
+  const unsigned char* ptr = begin;
+  const unsigned char* end = ptr + count;
+  const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
+  const unsigned char ch = (const unsigned char)val;
+  size_t found = 0;
+
+  if (count >= SIMD_LENGTH)
+  {
+    const __m128i target = _mm_set1_epi8(ch);
+
+    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+    {
+      const unsigned char* aligned = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
+      __m128i chunk = _mm_loadu_si128((const __m128i*)ptr);
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)) & ((1u << (aligned - ptr)) - 1);
+
+      for (; mask; mask &= mask - 1, found++)
+      {
+        if (!ImMemchrAllEmit(callback, size_t(ptr - begin) + ImCountTrailingZeros32(mask)))
+          return found + 1;
+      }
+
+      ptr = aligned;
+    }
+
+    // Four vectors are merged into one 64-bit mask
+    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
+    {
+      __m128i chunk1 = _mm_load_si128((const __m128i*)ptr);
+      __m128i chunk2 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH));
+      __m128i chunk3 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * 2));
+      __m128i chunk4 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * 3));
+
+      uint64_t mask1 = (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk1, target));
+      uint64_t mask2 = (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk2, target));
+      uint64_t mask3 = (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk3, target));
+      uint64_t mask4 = (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk4, target));
+      uint64_t mask = mask1 | (mask2 << 16) | (mask3 << 32) | (mask4 << 48);
+
+      for (; mask; mask &= mask - 1, found++)
+      {
+        if (!ImMemchrAllEmit(callback, size_t(ptr - begin) + ImCountTrailingZeros64(mask)))
+          return found + 1;
+      }
+    }
+
+    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    {
+      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+
+      for (; mask; mask &= mask - 1, found++)
+      {
+        if (!ImMemchrAllEmit(callback, size_t(ptr - begin) + ImCountTrailingZeros32(mask)))
+          return found + 1;
+      }
+    }
+  }
+
+  const ImMemchrTail tail = ImSimdSSE2::ScanTail(begin, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
+  {
+    for (uint64_t mask = tail.masks[i]; mask; mask &= mask - 1, found++)
+    {
+      if (!ImMemchrAllEmit(callback, size_t(tail.blocks[i] + ImCountTrailingZeros64(mask) - begin)))
+        return found + 1;
+    }
+  }
+
+  return found;
+}
+
+template <class Callback>
+size_t ImMemchrAllCSTD(const void* buf, int val, size_t count, Callback&& callback)
+{
+  const unsigned char* begin = (const unsigned char*)buf;
+  const unsigned char* ptr = begin;
+  const unsigned char* end = ptr + count;
+  size_t found = 0;
+
+  while (ptr < end)
+  {
+    ptr = (const unsigned char*)memchr(ptr, val, end - ptr);
+
+    if (!ptr)
+      break;
+
+    found++;
+    if (!ImMemchrAllEmit(callback, size_t(ptr - begin)))
+      break;
+
+    ptr++;
+  }
+
+  return found;
+}
+
+template <class Callback>
+using ImMemchrAllFunc = size_t (*)(const void* buf, int val, size_t count, Callback& callback);
+
+template <class Callback>
+size_t ImMemchrAllResolve(const void* buf, int val, size_t count, Callback& callback);
+
+// One per callback type
+template <class Callback>
+static std::atomic<ImMemchrAllFunc<Callback>> ImMemchrAllImpl{ ImMemchrAllResolve<Callback> };
+
+template <class Callback>
+size_t ImMemchrAllResolve(const void* buf, int val, size_t count, Callback& callback)
+{
+  ImMemchrAllFunc<Callback> func = ImMemchrAllCSTD<Callback&>;
+
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512))
+    func = ImMemchrAllAVX512<Callback&>;
+  else if (ImHasCpuFeatures(ImMemchrRequiredAVX2))
+    func = ImMemchrAllAVX2<Callback&>;
+  else if (ImHasCpuFeatures(ImMemchrRequiredSSE2))
+    func = ImMemchrAllSSE<Callback&>;
+
+  ImMemchrAllImpl<Callback>.store(func, std::memory_order_relaxed);
+  return func(buf, val, count, callback);
+}
+
+template <class Callback> requires std::invocable<Callback&, size_t>
+size_t ImMemchrAll(const void* buf, int val, size_t count, Callback&& callback)
+{
+  using CallbackT = std::remove_reference_t<Callback>;
+  return ImMemchrAllImpl<CallbackT>.load(std::memory_order_relaxed)(buf, val, count, callback);
+}
+
+// Writes match offsets into out until it is full, returns the number written.
+// A full span can be continued from out.back() + 1.
+size_t ImMemchrAll(const void* buf, int val, size_t count, std::span<size_t> out)
+{
+  if (out.empty())
+    return 0;
+
+  size_t written = 0;
+  return ImMemchrAll(buf, val, count, [&](size_t offset)
+  {
+    out[written++] = offset;
+    return written < out.size();
+  });
+}
+
+#pragma endregion
+// ALL_MATCHES
+
+#pragma region COUNT
+
+// ImMemcount counts the occurrences of a byte, ImMemchrNth returns the k-th (0-based) occurrence or nullptr.
+// Counting accumulates compare results in byte lanes and reduces them with psadbw before the lanes can
+// overflow. The Nth search skips whole vectors by popcount and resolves the exact bit only in the last one.
+// The SSE4.2 variants count with popcnt over the movemask instead of byte lanes.
+
+IMGUI_TARGET_SSE2
+static inline size_t ImMemcountReduceSSE(__m128i lanes)
+{
+  __m128i sums = _mm_sad_epu8(lanes, _mm_setzero_si128());
+  return (size_t)_mm_cvtsi128_si64(_mm_add_epi64(sums, _mm_unpackhi_epi64(sums, sums)));
+}
+
+IMGUI_TARGET_AVX2
+static inline size_t ImMemcountReduceAVX2(__m256i lanes)
+{
+  __m256i sums = _mm256_sad_epu8(lanes, _mm256_setzero_si256());
+  __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+  return (size_t)_mm_cvtsi128_si64(_mm_add_epi64(half, _mm_unpackhi_epi64(half, half)));
+}
+
+IMGUI_TARGET_AVX512
+static inline size_t ImMemcountReduceAVX512(__m512i lanes)
+{
+  return (size_t)_mm512_reduce_add_epi64(_mm512_sad_epu8(lanes, _mm512_setzero_si512()));
+}
+
+typedef size_t (*ImMemcountFunc)(const void* buf, int val, size_t count);
+typedef const void* (*ImMemchrNthFunc)(const void* buf, int val, size_t count, size_t k);
+
+template <int UNROLL, bool PREFETCH>
+IMGUI_TARGET_AVX512 IMGUI_NO_SANITIZE_ADDRESS
+size_t ImMemcountAVX512_Impl(const void* buf, int val, size_t count)
+{
+  const size_t SIMD_LENGTH = 64;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
+  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  const size_t LANE_FLUSH_ITERATIONS = 255 / UNROLL;
+
+  const unsigned char* ptr = (const unsigned char*)buf;
+  const unsigned char* end = ptr + count;
+  const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
+  const unsigned char ch = (const unsigned char)val;
+  size_t total = 0;
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_AVX512), ptr, end) : ImPrefetcher();
+
+  if (count >= SIMD_LENGTH)
+  {
+    const __m512i target = _mm512_set1_epi8(ch);
+    const __m512i one = _mm512_set1_epi8(1);
+
+    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+    {
+      const unsigned char* aligned = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      __m512i chunk = _mm512_loadu_si512((const __m512i*)ptr);
+      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target) & ((1ull << (aligned - ptr)) - 1);
+
+      total += _mm_popcnt_u64(mask);
+      ptr = aligned;
+    }
+
+    __m512i lanes = _mm512_setzero_si512();
+    size_t lane_iterations = 0;
+
+    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
+    {
+      for (int i = 0; i < UNROLL; i++)
+      {
+        __mmask64 mask = _mm512_cmpeq_epi8_mask(_mm512_load_si512((const __m512i*)(ptr + SIMD_LENGTH * i)), target);
+        lanes = _mm512_mask_add_epi8(lanes, mask, lanes, one);
+      }
+
+      if (++lane_iterations == LANE_FLUSH_ITERATIONS)
+      {
+        total += ImMemcountReduceAVX512(lanes);
+        lanes = _mm512_setzero_si512();
+        lane_iterations = 0;
+      }
+
+      if constexpr (PREFETCH)
+      {
+        prefetcher(ptr);
+      }
+    }
 
-const void* ImMemchrAVX512_PREFETCH(const void* buf, int val, size_t count)
+    total += ImMemcountReduceAVX512(lanes);
+
+    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    {
+      __m512i chunk = _mm512_load_si512((const __m512i*)ptr);
+      total += _mm_popcnt_u64(_mm512_cmpeq_epi8_mask(chunk, target));
+    }
+  }
+
+  const ImMemchrTail tail = ImSimdAVX512::ScanTail((const unsigned char*)buf, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
+    total += _mm_popcnt_u64(tail.masks[i]);
+
+  return total;
+}
+
+template <int UNROLL, bool PREFETCH>
+IMGUI_TARGET_AVX512 IMGUI_NO_SANITIZE_ADDRESS
+const void* ImMemchrNthAVX512_Impl(const void* buf, int val, size_t count, size_t k)
 {
   const size_t SIMD_LENGTH = 64;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
+  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+
+  const unsigned char* ptr = (const unsigned char*)buf;
+  const unsigned char* end = ptr + count;
+  const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
+  const unsigned char ch = (const unsigned char)val;
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_AVX512), ptr, end) : ImPrefetcher();
+
+  if (count >= SIMD_LENGTH)
+  {
+    const __m512i target = _mm512_set1_epi8(ch);
+
+    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+    {
+      const unsigned char* aligned = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      __m512i chunk = _mm512_loadu_si512((const __m512i*)ptr);
+      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target) & ((1ull << (aligned - ptr)) - 1);
+      size_t found = _mm_popcnt_u64(mask);
+
+      if (k < found)
+        return (const void*)(ptr + ImSelectSetBit64(mask, k));
+
+      k -= found;
+      ptr = aligned;
+    }
+
+    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
+    {
+      uint64_t masks[UNROLL];
+      size_t found = 0;
+
+      for (int i = 0; i < UNROLL; i++)
+      {
+        masks[i] = _mm512_cmpeq_epi8_mask(_mm512_load_si512((const __m512i*)(ptr + SIMD_LENGTH * i)), target);
+        found += _mm_popcnt_u64(masks[i]);
+      }
+
+      if (k < found)
+      {
+        for (int i = 0; i < UNROLL; i++)
+        {
+          size_t vector_found = _mm_popcnt_u64(masks[i]);
+
+          if (k < vector_found)
+            return (const void*)(ptr + SIMD_LENGTH * i + ImSelectSetBit64(masks[i], k));
+
+          k -= vector_found;
+        }
+      }
+
+      k -= found;
+
+      if constexpr (PREFETCH)
+      {
+        prefetcher(ptr);
+      }
+    }
+
+    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    {
+      __m512i chunk = _mm512_load_si512((const __m512i*)ptr);
+      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target);
+      size_t found = _mm_popcnt_u64(mask);
+
+      if (k < found)
+        return (const void*)(ptr + ImSelectSetBit64(mask, k));
+
+      k -= found;
+    }
+  }
+
+  const ImMemchrTail tail = ImSimdAVX512::ScanTail((const unsigned char*)buf, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
+  {
+    size_t found = _mm_popcnt_u64(tail.masks[i]);
+
+    if (k < found)
+      return (const void*)(tail.blocks[i] + ImSelectSetBit64(tail.masks[i], k));
+
+    k -= found;
+  }
+
+  return nullptr;
+}
+
+template <int UNROLL, bool PREFETCH>
+IMGUI_TARGET_AVX2 IMGUI_NO_SANITIZE_ADDRESS
+size_t ImMemcountAVX2_Impl(const void* buf, int val, size_t count)
+{
+  const size_t SIMD_LENGTH = 32;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
+  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  const size_t LANE_FLUSH_ITERATIONS = 255 / UNROLL;
+
+  const unsigned char* ptr = (const unsigned char*)buf;
+  const unsigned char* end = ptr + count;
+  const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
+  const unsigned char ch = (const unsigned char)val;
+  size_t total = 0;
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_AVX2), ptr, end) : ImPrefetcher();
+
+  if (count >= SIMD_LENGTH)
+  {
+    const __m256i target = _mm256_set1_epi8(ch);
+
+    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+    {
+      const unsigned char* aligned = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      __m256i chunk = _mm256_lddqu_si256((const __m256i*)ptr);
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target)) & ((1u << (aligned - ptr)) - 1);
+
+      total += _mm_popcnt_u32(mask);
+      ptr = aligned;
+    }
+
+    // cmpeq yields -1 per match, subtracting it counts matches per byte lane
+    __m256i lanes = _mm256_setzero_si256();
+    size_t lane_iterations = 0;
+
+    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
+    {
+      for (int i = 0; i < UNROLL; i++)
+      {
+        __m256i chunk = _mm256_load_si256((const __m256i*)(ptr + SIMD_LENGTH * i));
+        lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(chunk, target));
+      }
+
+      if (++lane_iterations == LANE_FLUSH_ITERATIONS)
+      {
+        total += ImMemcountReduceAVX2(lanes);
+        lanes = _mm256_setzero_si256();
+        lane_iterations = 0;
+      }
+
+      if constexpr (PREFETCH)
+      {
+        prefetcher(ptr);
+      }
+    }
+
+    total += ImMemcountReduceAVX2(lanes);
+
+    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    {
+      __m256i chunk = _mm256_load_si256((const __m256i*)ptr);
+      total += _mm_popcnt_u32((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target)));
+    }
+  }
+
+  const ImMemchrTail tail = ImSimdAVX2::ScanTail((const unsigned char*)buf, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
+    total += _mm_popcnt_u64(tail.masks[i]);
+
+  return total;
+}
+
+template <int UNROLL, bool PREFETCH>
+IMGUI_TARGET_AVX2 IMGUI_NO_SANITIZE_ADDRESS
+const void* ImMemchrNthAVX2_Impl(const void* buf, int val, size_t count, size_t k)
+{
+  const size_t SIMD_LENGTH = 32;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
+  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+
+  const unsigned char* ptr = (const unsigned char*)buf;
+  const unsigned char* end = ptr + count;
+  const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
+  const unsigned char ch = (const unsigned char)val;
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_AVX2), ptr, end) : ImPrefetcher();
+
+  if (count >= SIMD_LENGTH)
+  {
+    const __m256i target = _mm256_set1_epi8(ch);
+
+    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+    {
+      const unsigned char* aligned = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      __m256i chunk = _mm256_lddqu_si256((const __m256i*)ptr);
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target)) & ((1u << (aligned - ptr)) - 1);
+      size_t found = _mm_popcnt_u32(mask);
+
+      if (k < found)
+        return (const void*)(ptr + ImSelectSetBit64(mask, k));
+
+      k -= found;
+      ptr = aligned;
+    }
+
+    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
+    {
+      uint32_t masks[UNROLL];
+      size_t found = 0;
+
+      for (int i = 0; i < UNROLL; i++)
+      {
+        __m256i chunk = _mm256_load_si256((const __m256i*)(ptr + SIMD_LENGTH * i));
+        masks[i] = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+        found += _mm_popcnt_u32(masks[i]);
+      }
+
+      if (k < found)
+      {
+        for (int i = 0; i < UNROLL; i++)
+        {
+          size_t vector_found = _mm_popcnt_u32(masks[i]);
+
+          if (k < vector_found)
+            return (const void*)(ptr + SIMD_LENGTH * i + ImSelectSetBit64(masks[i], k));
+
+          k -= vector_found;
+        }
+      }
+
+      k -= found;
+
+      if constexpr (PREFETCH)
+      {
+        prefetcher(ptr);
+      }
+    }
+
+    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    {
+      __m256i chunk = _mm256_load_si256((const __m256i*)ptr);
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+      size_t found = _mm_popcnt_u32(mask);
+
+      if (k < found)
+        return (const void*)(ptr + ImSelectSetBit64(mask, k));
+
+      k -= found;
+    }
+  }
+
+  const ImMemchrTail tail = ImSimdAVX2::ScanTail((const unsigned char*)buf, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
+  {
+    size_t found = _mm_popcnt_u64(tail.masks[i]);
+
+    if (k < found)
+      return (const void*)(tail.blocks[i] + ImSelectSetBit64(tail.masks[i], k));
+
+    k -= found;
+  }
+
+  return nullptr;
+}
+
+template <int UNROLL, bool PREFETCH>
+IMGUI_TARGET_SSE4_2 IMGUI_NO_SANITIZE_ADDRESS
+size_t ImMemcountSSE4_2_Impl(const void* buf, int val, size_t count)
+{
+  const size_t SIMD_LENGTH = 16;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
   const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
 
   const unsigned char* ptr = (const unsigned char*)buf;
   const unsigned char* end = ptr + count;
   const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
   const unsigned char ch = (const unsigned char)val;
+  size_t total = 0;
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_SSE4_2), ptr, end) : ImPrefetcher();
 
-  if (ptr <= align_end)
+  if (count >= SIMD_LENGTH)
   {
-    const __m512i target = _mm512_set1_epi8(ch);
+    const __m128i target = _mm_set1_epi8(ch);
 
     if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
     {
-      __m512i chunk = _mm512_loadu_si512((const __m512i*)ptr);
-      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target);
-
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u64(mask));
+      const unsigned char* aligned = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
+      __m128i chunk = _mm_lddqu_si128((const __m128i*)ptr);
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)) & ((1u << (aligned - ptr)) - 1);
 
-      ptr = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      total += _mm_popcnt_u32(mask);
+      ptr = aligned;
     }
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
     {
-      __m512i chunk = _mm512_load_si512((const __m512i*)ptr);
-      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target);
+      uint64_t mask = 0;
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u64(mask));
+      for (int i = 0; i < UNROLL; i++)
+      {
+        __m128i chunk = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * i));
+        mask |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)) << (SIMD_LENGTH * i);
+      }
 
-      if (ptr <= end - IMGUI_PREFECTH_LENGTH)
-        _mm_prefetch((const char*)(ptr + IMGUI_PREFECTH_LENGTH), _MM_HINT_T0);
+      total += _mm_popcnt_u64(mask);
+
+      if constexpr (PREFETCH)
+      {
+        prefetcher(ptr);
+      }
     }
-  }
 
-  for (; ptr < end; ptr++)
-  {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    {
+      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
+      total += _mm_popcnt_u32((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)));
+    }
   }
 
-  return nullptr;
+  const ImMemchrTail tail = ImSimdSSE2::ScanTail((const unsigned char*)buf, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
+    total += _mm_popcnt_u64(tail.masks[i]);
+
+  return total;
 }
 
-const void* ImMemchrAVX512(const void* buf, int val, size_t count)
+template <int UNROLL, bool PREFETCH>
+IMGUI_TARGET_SSE4_2 IMGUI_NO_SANITIZE_ADDRESS
+const void* ImMemchrNthSSE4_2_Impl(const void* buf, int val, size_t count, size_t k)
 {
-  const size_t SIMD_LENGTH = 64;
+  const size_t SIMD_LENGTH = 16;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
   const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
 
   const unsigned char* ptr = (const unsigned char*)buf;
   const unsigned char* end = ptr + count;
   const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
   const unsigned char ch = (const unsigned char)val;
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_SSE4_2), ptr, end) : ImPrefetcher();
 
-  if (ptr <= align_end)
+  if (count >= SIMD_LENGTH)
   {
-    const __m512i target = _mm512_set1_epi8(ch);
+    const __m128i target = _mm_set1_epi8(ch);
 
     if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
     {
-      __m512i chunk = _mm512_loadu_si512((const __m512i*)ptr);
-      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target);
+      const unsigned char* aligned = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
+      __m128i chunk = _mm_lddqu_si128((const __m128i*)ptr);
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)) & ((1u << (aligned - ptr)) - 1);
+      size_t found = _mm_popcnt_u32(mask);
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u64(mask));
+      if (k < found)
+        return (const void*)(ptr + ImSelectSetBit64(mask, k));
+
+      k -= found;
+      ptr = aligned;
+    }
+
+    // Up to four vectors fit in one 64-bit mask, so the exact bit is resolved without a per-vector pass
+    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
+    {
+      uint64_t mask = 0;
+
+      for (int i = 0; i < UNROLL; i++)
+      {
+        __m128i chunk = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * i));
+        mask |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)) << (SIMD_LENGTH * i);
+      }
 
-      ptr = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      size_t found = _mm_popcnt_u64(mask);
+
+      if (k < found)
+        return (const void*)(ptr + ImSelectSetBit64(mask, k));
+
+      k -= found;
+
+      if constexpr (PREFETCH)
+      {
+        prefetcher(ptr);
+      }
     }
 
     for (; ptr <= align_end; ptr += SIMD_LENGTH)
     {
-      __m512i chunk = _mm512_load_si512((const __m512i*)ptr);
-      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target);
+      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+      size_t found = _mm_popcnt_u32(mask);
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u64(mask));
+      if (k < found)
+        return (const void*)(ptr + ImSelectSetBit64(mask, k));
+
+      k -= found;
     }
   }
 
-  for (; ptr < end; ptr++)
+  const ImMemchrTail tail = ImSimdSSE2::ScanTail((const unsigned char*)buf, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    size_t found = _mm_popcnt_u64(tail.masks[i]);
+
+    if (k < found)
+      return (const void*)(tail.blocks[i] + ImSelectSetBit64(tail.masks[i], k));
+
+    k -= found;
   }
 
   return nullptr;
 }
 
-
-const void* ImMemchrAVX2_UNROLL_PREFETCH(const void* buf, int val, size_t count)
+template <int UNROLL, bool PREFETCH>
+IMGUI_TARGET_SSE2 IMGUI_NO_SANITIZE_ADDRESS
+size_t ImMemcountSSE_Impl(const void* buf, int val, size_t count)
 {
-  const size_t SIMD_LENGTH = 32;
-  const size_t SIMD_UNROLLED_LENGTH = 32 * 4;
+  const size_t SIMD_LENGTH = 16;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
   const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  const size_t LANE_FLUSH_ITERATIONS = 255 / UNROLL;
 
   const unsigned char* ptr = (const unsigned char*)buf;
   const unsigned char* end = ptr + count;
   const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char* align_unroll_end = end - SIMD_LENGTH * SIMD_UNROLLED_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
   const unsigned char ch = (const unsigned char)val;
+  size_t total = 0;
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_SSE), ptr, end) : ImPrefetcher();
 
-  if (ptr <= align_end)
+  if (count >= SIMD_LENGTH)
   {
-    const __m256i target = _mm256_set1_epi8(ch);
+    const __m128i target = _mm_set1_epi8(ch);
 
     if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
     {
-      __m256i chunk = _mm256_lddqu_si256((const __m256i*)ptr);
-      int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
-
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+      const unsigned char* aligned = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
+      __m128i chunk = _mm_loadu_si128((const __m128i*)ptr);
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)) & ((1u << (aligned - ptr)) - 1);
 
-      ptr = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      total += ImCountSetBits64(mask);
+      ptr = aligned;
     }
 
+    // cmpeq yields -1 per match, subtracting it counts matches per byte lane
+    __m128i lanes = _mm_setzero_si128();
+    size_t lane_iterations = 0;
+
     for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
     {
-      __m256i chunk1 = _mm256_load_si256((const __m256i*)ptr);
-      __m256i chunk2 = _mm256_load_si256((const __m256i*)(ptr + SIMD_LENGTH));
-      __m256i chunk3 = _mm256_load_si256((const __m256i*)(ptr + SIMD_LENGTH * 2));
-      __m256i chunk4 = _mm256_load_si256((const __m256i*)(ptr + SIMD_LENGTH * 3));
-
-      int mask1 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk1, target));
-      int mask2 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk2, target));
-      int mask3 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk3, target));
-      int mask4 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk4, target));
-
-      if (mask1)
-        return (const void*)(ptr + _tzcnt_u32(mask1));
-      else if (mask2)
-        return (const void*)(ptr + SIMD_LENGTH + _tzcnt_u32(mask2));
-      else if (mask3)
-        return (const void*)(ptr + SIMD_LENGTH * 2 + _tzcnt_u32(mask3));
-      else if (mask4)
-        return (const void*)(ptr + SIMD_LENGTH * 3 + _tzcnt_u32(mask4));
-
-      if (ptr <= end - IMGUI_PREFECTH_LENGTH)
-        _mm_prefetch((const char*)(ptr + IMGUI_PREFECTH_LENGTH), _MM_HINT_T0);
+      for (int i = 0; i < UNROLL; i++)
+      {
+        __m128i chunk = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * i));
+        lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(chunk, target));
+      }
+
+      if (++lane_iterations == LANE_FLUSH_ITERATIONS)
+      {
+        total += ImMemcountReduceSSE(lanes);
+        lanes = _mm_setzero_si128();
+        lane_iterations = 0;
+      }
+
+      if constexpr (PREFETCH)
+      {
+        prefetcher(ptr);
+      }
     }
 
     for (; ptr <= align_end; ptr += SIMD_LENGTH)
     {
-      __m256i chunk = _mm256_load_si256((const __m256i*)ptr);
-      int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
-
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
-
-      if (ptr <= end - IMGUI_PREFECTH_LENGTH)
-        _mm_prefetch((const char*)(ptr + IMGUI_PREFECTH_LENGTH), _MM_HINT_T0);
+      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
+      lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(chunk, target));
     }
-  }
 
-  for (; ptr < end; ptr++)
-  {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    // The trailing loop runs less than UNROLL times, so the lanes cannot overflow
+    total += ImMemcountReduceSSE(lanes);
   }
 
-  return nullptr;
+  const ImMemchrTail tail = ImSimdSSE2::ScanTail((const unsigned char*)buf, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
+    total += ImCountSetBits64(tail.masks[i]);
+
+  return total;
 }
 
-const void* ImMemchrAVX2_UNROLL(const void* buf, int val, size_t count)
+template <int UNROLL, bool PREFETCH>
+IMGUI_TARGET_SSE2 IMGUI_NO_SANITIZE_ADDRESS
+const void* ImMemchrNthSSE_Impl(const void* buf, int val, size_t count, size_t k)
 {
-  const size_t SIMD_LENGTH = 32;
-  const size_t SIMD_UNROLLED_LENGTH = 32 * 4;
+  const size_t SIMD_LENGTH = 16;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
   const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
 
   const unsigned char* ptr = (const unsigned char*)buf;
   const unsigned char* end = ptr + count;
   const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char* align_unroll_end = end - SIMD_LENGTH * SIMD_UNROLLED_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
   const unsigned char ch = (const unsigned char)val;
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_SSE), ptr, end) : ImPrefetcher();
 
-  if (ptr <= align_end)
+  if (count >= SIMD_LENGTH)
   {
-    const __m256i target = _mm256_set1_epi8(ch);
+    const __m128i target = _mm_set1_epi8(ch);
 
     if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
     {
-      __m256i chunk = _mm256_lddqu_si256((const __m256i*)ptr);
-      int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+      const unsigned char* aligned = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
+      __m128i chunk = _mm_loadu_si128((const __m128i*)ptr);
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)) & ((1u << (aligned - ptr)) - 1);
+      size_t found = ImCountSetBits64(mask);
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+      if (k < found)
+        return (const void*)(ptr + ImSelectSetBit64(mask, k));
 
-      ptr = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      k -= found;
+      ptr = aligned;
     }
 
+    // Without POPCNT the block is counted with psadbw and the bitmask is only built for the hit block
     for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
     {
-      __m256i chunk1 = _mm256_load_si256((const __m256i*)ptr);
-      __m256i chunk2 = _mm256_load_si256((const __m256i*)(ptr + SIMD_LENGTH));
-      __m256i chunk3 = _mm256_load_si256((const __m256i*)(ptr + SIMD_LENGTH * 2));
-      __m256i chunk4 = _mm256_load_si256((const __m256i*)(ptr + SIMD_LENGTH * 3));
+      __m128i chunks[UNROLL];
+      __m128i lanes = _mm_setzero_si128();
+
+      for (int i = 0; i < UNROLL; i++)
+      {
+        chunks[i] = _mm_cmpeq_epi8(_mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * i)), target);
+        lanes = _mm_sub_epi8(lanes, chunks[i]);
+      }
+
+      size_t found = ImMemcountReduceSSE(lanes);
+
+      if (k < found)
+      {
+        uint64_t mask = 0;
 
-      int mask1 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk1, target));
-      int mask2 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk2, target));
-      int mask3 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk3, target));
-      int mask4 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk4, target));
+        for (int i = 0; i < UNROLL; i++)
+          mask |= (uint64_t)_mm_movemask_epi8(chunks[i]) << (SIMD_LENGTH * i);
 
-      if (mask1)
-        return (const void*)(ptr + _tzcnt_u32(mask1));
-      else if (mask2)
-        return (const void*)(ptr + SIMD_LENGTH + _tzcnt_u32(mask2));
-      else if (mask3)
-        return (const void*)(ptr + SIMD_LENGTH * 2 + _tzcnt_u32(mask3));
-      else if (mask4)
-        return (const void*)(ptr + SIMD_LENGTH * 3 + _tzcnt_u32(mask4));
+        return (const void*)(ptr + ImSelectSetBit64(mask, k));
+      }
+
+      k -= found;
+
+      if constexpr (PREFETCH)
+      {
+        prefetcher(ptr);
+      }
     }
 
     for (; ptr <= align_end; ptr += SIMD_LENGTH)
     {
-      __m256i chunk = _mm256_load_si256((const __m256i*)ptr);
-      int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
 
       if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+      {
+        size_t found = ImCountSetBits64(mask);
+
+        if (k < found)
+          return (const void*)(ptr + ImSelectSetBit64(mask, k));
+
+        k -= found;
+      }
     }
   }
 
-  for (; ptr < end; ptr++)
+  const ImMemchrTail tail = ImSimdSSE2::ScanTail((const unsigned char*)buf, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    size_t found = ImCountSetBits64(tail.masks[i]);
+
+    if (k < found)
+      return (const void*)(tail.blocks[i] + ImSelectSetBit64(tail.masks[i], k));
+
+    k -= found;
   }
 
   return nullptr;
 }
 
-const void* ImMemchrAVX2_PREFETCH(const void* buf, int val, size_t count)
-{
-  const size_t SIMD_LENGTH = 32;
-  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+size_t ImMemcountAVX512_PREFETCH(const void* buf, int val, size_t count)        { return ImMemcountAVX512_Impl<1, true>(buf, val, count); }
+size_t ImMemcountAVX512(const void* buf, int val, size_t count)                 { return ImMemcountAVX512_Impl<1, false>(buf, val, count); }
+
+size_t ImMemcountAVX2_UNROLL_PREFETCH(const void* buf, int val, size_t count)   { return ImMemcountAVX2_Impl<4, true>(buf, val, count); }
+size_t ImMemcountAVX2_UNROLL(const void* buf, int val, size_t count)            { return ImMemcountAVX2_Impl<4, false>(buf, val, count); }
+size_t ImMemcountAVX2_PREFETCH(const void* buf, int val, size_t count)          { return ImMemcountAVX2_Impl<1, true>(buf, val, count); }
+size_t ImMemcountAVX2(const void* buf, int val, size_t count)                   { return ImMemcountAVX2_Impl<1, false>(buf, val, count); }
+
+size_t ImMemcountSSE4_2_UNROLL_PREFETCH(const void* buf, int val, size_t count) { return ImMemcountSSE4_2_Impl<2, true>(buf, val, count); }
+size_t ImMemcountSSE4_2_UNROLL(const void* buf, int val, size_t count)          { return ImMemcountSSE4_2_Impl<2, false>(buf, val, count); }
+size_t ImMemcountSSE4_2_PREFETCH(const void* buf, int val, size_t count)        { return ImMemcountSSE4_2_Impl<1, true>(buf, val, count); }
+size_t ImMemcountSSE4_2(const void* buf, int val, size_t count)                 { return ImMemcountSSE4_2_Impl<1, false>(buf, val, count); }
+
+size_t ImMemcountSSE_UNROLL_PREFETCH(const void* buf, int val, size_t count)    { return ImMemcountSSE_Impl<4, true>(buf, val, count); }
+size_t ImMemcountSSE_UNROLL(const void* buf, int val, size_t count)             { return ImMemcountSSE_Impl<4, false>(buf, val, count); }
+size_t ImMemcountSSE_PREFETCH(const void* buf, int val, size_t count)           { return ImMemcountSSE_Impl<1, true>(buf, val, count); }
+size_t ImMemcountSSE(const void* buf, int val, size_t count)                    { return ImMemcountSSE_Impl<1, false>(buf, val, count); }
 
+size_t ImMemcountCSTD(const void* buf, int val, size_t count)
+{
   const unsigned char* ptr = (const unsigned char*)buf;
   const unsigned char* end = ptr + count;
-  const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char ch = (const unsigned char)val;
+  size_t total = 0;
 
-  if (ptr <= align_end)
+  while (ptr < end && (ptr = (const unsigned char*)memchr(ptr, val, end - ptr)))
   {
-    const __m256i target = _mm256_set1_epi8(ch);
+    total++;
+    ptr++;
+  }
 
-    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
-    {
-      __m256i chunk = _mm256_lddqu_si256((const __m256i*)ptr);
-      int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+  return total;
+}
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+const void* ImMemchrNthAVX512_PREFETCH(const void* buf, int val, size_t count, size_t k)        { return ImMemchrNthAVX512_Impl<1, true>(buf, val, count, k); }
+const void* ImMemchrNthAVX512(const void* buf, int val, size_t count, size_t k)                 { return ImMemchrNthAVX512_Impl<1, false>(buf, val, count, k); }
 
-      ptr = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
-    }
+const void* ImMemchrNthAVX2_UNROLL_PREFETCH(const void* buf, int val, size_t count, size_t k)   { return ImMemchrNthAVX2_Impl<4, true>(buf, val, count, k); }
+const void* ImMemchrNthAVX2_UNROLL(const void* buf, int val, size_t count, size_t k)            { return ImMemchrNthAVX2_Impl<4, false>(buf, val, count, k); }
+const void* ImMemchrNthAVX2_PREFETCH(const void* buf, int val, size_t count, size_t k)          { return ImMemchrNthAVX2_Impl<1, true>(buf, val, count, k); }
+const void* ImMemchrNthAVX2(const void* buf, int val, size_t count, size_t k)                   { return ImMemchrNthAVX2_Impl<1, false>(buf, val, count, k); }
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH)
-    {
-      __m256i chunk = _mm256_load_si256((const __m256i*)ptr);
-      int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+const void* ImMemchrNthSSE4_2_UNROLL_PREFETCH(const void* buf, int val, size_t count, size_t k) { return ImMemchrNthSSE4_2_Impl<2, true>(buf, val, count, k); }
+const void* ImMemchrNthSSE4_2_UNROLL(const void* buf, int val, size_t count, size_t k)          { return ImMemchrNthSSE4_2_Impl<2, false>(buf, val, count, k); }
+const void* ImMemchrNthSSE4_2_PREFETCH(const void* buf, int val, size_t count, size_t k)        { return ImMemchrNthSSE4_2_Impl<1, true>(buf, val, count, k); }
+const void* ImMemchrNthSSE4_2(const void* buf, int val, size_t count, size_t k)                 { return ImMemchrNthSSE4_2_Impl<1, false>(buf, val, count, k); }
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+const void* ImMemchrNthSSE_UNROLL_PREFETCH(const void* buf, int val, size_t count, size_t k)    { return ImMemchrNthSSE_Impl<4, true>(buf, val, count, k); }
+const void* ImMemchrNthSSE_UNROLL(const void* buf, int val, size_t count, size_t k)             { return ImMemchrNthSSE_Impl<4, false>(buf, val, count, k); }
+const void* ImMemchrNthSSE_PREFETCH(const void* buf, int val, size_t count, size_t k)           { return ImMemchrNthSSE_Impl<1, true>(buf, val, count, k); }
+const void* ImMemchrNthSSE(const void* buf, int val, size_t count, size_t k)                    { return ImMemchrNthSSE_Impl<1, false>(buf, val, count, k); }
 
-      if (ptr <= end - IMGUI_PREFECTH_LENGTH)
-        _mm_prefetch((const char*)(ptr + IMGUI_PREFECTH_LENGTH), _MM_HINT_T0);
-    }
-  }
+const void* ImMemchrNthCSTD(const void* buf, int val, size_t count, size_t k)
+{
+  const unsigned char* ptr = (const unsigned char*)buf;
+  const unsigned char* end = ptr + count;
 
-  for (; ptr < end; ptr++)
+  while (ptr < end && (ptr = (const unsigned char*)memchr(ptr, val, end - ptr)))
   {
-    if (*ptr == ch)
+    if (k-- == 0)
       return (const void*)(ptr);
+
+    ptr++;
   }
 
   return nullptr;
 }
 
-const void* ImMemchrAVX2(const void* buf, int val, size_t count)
+size_t ImMemcountResolve(const void* buf, int val, size_t count);
+
+static std::atomic<ImMemcountFunc> ImMemcountImpl{ ImMemcountResolve };
+
+size_t ImMemcountResolve(const void* buf, int val, size_t count)
 {
-  const size_t SIMD_LENGTH = 32;
+  ImMemcountFunc func = ImMemcountCSTD;
+
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512))
+    func = ImMemcountAVX512;
+  else if (ImHasCpuFeatures(ImMemchrRequiredAVX2))
+    func = ImMemcountAVX2_UNROLL;
+  else if (ImHasCpuFeatures(ImMemchrRequiredSSE2))
+    func = ImMemcountSSE_UNROLL;
+
+  ImMemcountImpl.store(func, std::memory_order_relaxed);
+  return func(buf, val, count);
+}
+
+size_t ImMemcount(const void* buf, int val, size_t count)
+{
+  return ImMemcountImpl.load(std::memory_order_relaxed)(buf, val, count);
+}
+
+const void* ImMemchrNthResolve(const void* buf, int val, size_t count, size_t k);
+
+static std::atomic<ImMemchrNthFunc> ImMemchrNthImpl{ ImMemchrNthResolve };
+
+const void* ImMemchrNthResolve(const void* buf, int val, size_t count, size_t k)
+{
+  ImMemchrNthFunc func = ImMemchrNthCSTD;
+
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512))
+    func = ImMemchrNthAVX512;
+  else if (ImHasCpuFeatures(ImMemchrRequiredAVX2))
+    func = ImMemchrNthAVX2_UNROLL;
+  else if (ImHasCpuFeatures(ImMemchrRequiredSSE2))
+    func = ImMemchrNthSSE_UNROLL;
+
+  ImMemchrNthImpl.store(func, std::memory_order_relaxed);
+  return func(buf, val, count, k);
+}
+
+const void* ImMemchrNth(const void* buf, int val, size_t count, size_t k)
+{
+  return ImMemchrNthImpl.load(std::memory_order_relaxed)(buf, val, count, k);
+}
+
+#pragma endregion
+// COUNT
+
+#pragma region OFFSETS
+
+// Offset kernels write base + offset of every match into out and return the number written.
+// out must have room for one entry per scanned byte in the worst case.
+
+template <class OffsetT>
+using ImMemchrOffsetsFunc = size_t (*)(const void* buf, int val, size_t count, OffsetT base, OffsetT* out);
+
+// Widens up to 64 packed byte indices to offsets, 16 (32-bit) or 8 (64-bit) per masked store
+template <class OffsetT>
+IMGUI_TARGET_AVX512_VBMI2
+static inline size_t ImMemchrOffsetsCompressStore(uint64_t mask, const __m512i& lane_index, OffsetT base, OffsetT* out)
+{
+  static_assert(sizeof(OffsetT) == 4 || sizeof(OffsetT) == 8, "Compress-store supports 32 and 64-bit offsets");
+
+  alignas(64) unsigned char packed[64];
+  _mm512_store_si512((__m512i*)packed, _mm512_maskz_compress_epi8(mask, lane_index));
+  const size_t found = _mm_popcnt_u64(mask);
+
+  if constexpr (sizeof(OffsetT) == 4)
+  {
+    const __m512i vbase = _mm512_set1_epi32((int)base);
+
+    for (size_t i = 0; i < found; i += 16)
+    {
+      __m512i offsets = _mm512_add_epi32(_mm512_cvtepu8_epi32(_mm_load_si128((const __m128i*)(packed + i))), vbase);
+      size_t left = found - i;
+      _mm512_mask_storeu_epi32(out + i, left >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << left) - 1), offsets);
+    }
+  }
+  else
+  {
+    const __m512i vbase = _mm512_set1_epi64((long long)base);
+
+    for (size_t i = 0; i < found; i += 8)
+    {
+      __m512i offsets = _mm512_add_epi64(_mm512_cvtepu8_epi64(_mm_loadl_epi64((const __m128i*)(packed + i))), vbase);
+      size_t left = found - i;
+      _mm512_mask_storeu_epi64(out + i, left >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << left) - 1), offsets);
+    }
+  }
+
+  return found;
+}
+
+template <class OffsetT>
+IMGUI_TARGET_AVX512_VBMI2 IMGUI_NO_SANITIZE_ADDRESS
+size_t ImMemchrOffsetsAVX512_VBMI2(const void* buf, int val, size_t count, OffsetT base, OffsetT* out)
+{
+  const size_t SIMD_LENGTH = 64;
   const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
 
-  const unsigned char* ptr = (const unsigned char*)buf;
+  const unsigned char* begin = (const unsigned char*)buf;
+  const unsigned char* ptr = begin;
   const unsigned char* end = ptr + count;
   const unsigned char* align_end = end - SIMD_LENGTH;
   const unsigned char ch = (const unsigned char)val;
+  size_t found = 0;
 
-  if (ptr <= align_end)
+  const __m512i lane_index = _mm512_set_epi8(
+    63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48,
+    47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32,
+    31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16,
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+
+  if (count >= SIMD_LENGTH)
   {
-    const __m256i target = _mm256_set1_epi8(ch);
+    const __m512i target = _mm512_set1_epi8(ch);
 
     if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
     {
-      __m256i chunk = _mm256_lddqu_si256((const __m256i*)ptr);
-      int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+      const unsigned char* aligned = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      __m512i chunk = _mm512_loadu_si512((const __m512i*)ptr);
+      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target) & ((1ull << (aligned - ptr)) - 1);
 
       if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+        found += ImMemchrOffsetsCompressStore<OffsetT>(mask, lane_index, base, out + found);
 
-      ptr = (const unsigned char*)_andn_u64(SIMD_LENGTH_MASK, (uintptr_t)ptr + SIMD_LENGTH_MASK);
+      ptr = aligned;
     }
 
     for (; ptr <= align_end; ptr += SIMD_LENGTH)
     {
-      __m256i chunk = _mm256_load_si256((const __m256i*)ptr);
-      int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+      __m512i chunk = _mm512_load_si512((const __m512i*)ptr);
+      uint64_t mask = _mm512_cmpeq_epi8_mask(chunk, target);
 
       if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+        found += ImMemchrOffsetsCompressStore<OffsetT>(mask, lane_index, (OffsetT)(base + (ptr - begin)), out + found);
     }
   }
 
-  for (; ptr < end; ptr++)
+  // The first vector of a short buffer starts before begin, its offsets wrap around and its lane indices
+  // bring them back
+  const ImMemchrTail tail = ImSimdAVX512::ScanTail(begin, ptr, end, ch);
+
+  for (int i = 0; i < tail.count; i++)
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    if (tail.masks[i])
+      found += ImMemchrOffsetsCompressStore<OffsetT>(tail.masks[i], lane_index, (OffsetT)(base + (OffsetT)(tail.blocks[i] - begin)), out + found);
   }
 
-  return nullptr;
+  return found;
 }
 
-
-const void* ImMemchrSSE4_2_UNROLL_PREFETCH(const void* buf, int val, size_t count)
+template <class OffsetT>
+size_t ImMemchrOffsetsAVX512(const void* buf, int val, size_t count, OffsetT base, OffsetT* out)
 {
-  const size_t SIMD_LENGTH = 16;
-  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  size_t found = 0;
+  ImMemchrAllAVX512(buf, val, count, [&](size_t offset) { out[found++] = (OffsetT)(base + offset); });
+  return found;
+}
 
-  const unsigned char* ptr = (const unsigned char*)buf;
-  const unsigned char* end = ptr + count;
-  const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char ch = (const unsigned char)val;
+template <class OffsetT>
+size_t ImMemchrOffsetsAVX2(const void* buf, int val, size_t count, OffsetT base, OffsetT* out)
+{
+  size_t found = 0;
+  ImMemchrAllAVX2(buf, val, count, [&](size_t offset) { out[found++] = (OffsetT)(base + offset); });
+  return found;
+}
 
-  if (ptr <= align_end)
-  {
-    const __m128i target = _mm_set1_epi8(ch);
+template <class OffsetT>
+size_t ImMemchrOffsetsSSE(const void* buf, int val, size_t count, OffsetT base, OffsetT* out)
+{
+  size_t found = 0;
+  ImMemchrAllSSE(buf, val, count, [&](size_t offset) { out[found++] = (OffsetT)(base + offset); });
+  return found;
+}
 
-    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
-    {
-      __m128i chunk = _mm_lddqu_si128((const __m128i*)ptr);
-      int index = _mm_cmpistri(chunk, target, _SIDD_CMP_EQUAL_EACH);
+template <class OffsetT>
+size_t ImMemchrOffsetsCSTD(const void* buf, int val, size_t count, OffsetT base, OffsetT* out)
+{
+  size_t found = 0;
+  ImMemchrAllCSTD(buf, val, count, [&](size_t offset) { out[found++] = (OffsetT)(base + offset); });
+  return found;
+}
 
-      if (index < SIMD_LENGTH)
-        return ptr + index;
+template <class OffsetT>
+ImMemchrOffsetsFunc<OffsetT> ImMemchrSelectOffsets()
+{
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512_VBMI2))
+    return ImMemchrOffsetsAVX512_VBMI2<OffsetT>;
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512))
+    return ImMemchrOffsetsAVX512<OffsetT>;
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX2))
+    return ImMemchrOffsetsAVX2<OffsetT>;
+  if (ImHasCpuFeatures(ImMemchrRequiredSSE2))
+    return ImMemchrOffsetsSSE<OffsetT>;
+
+  return ImMemchrOffsetsCSTD<OffsetT>;
+}
 
-      ptr = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
-    }
+#pragma endregion
+// OFFSETS
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH * 2)
-    {
-      __m128i chunk1 = _mm_load_si128((const __m128i*)ptr);
-      __m128i chunk2 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH));
+#pragma region MEMMEM
 
-      int index1 = _mm_cmpistri(chunk1, target, _SIDD_CMP_EQUAL_EACH);
-      int index2 = _mm_cmpistri(chunk2, target, _SIDD_CMP_EQUAL_EACH);
+// ImMemmem returns the first occurrence of needle in haystack or nullptr, like memmem.
+// Every vector compares the first needle byte at ptr and the last needle byte at ptr + needle_len - 1,
+// only positions where both match are verified. Needles of 2 bytes need no verification, needles of
+// 3 to 16 bytes compare two overlapping words, longer ones fall back to memcmp on the middle bytes.
+// Single byte needles go straight to the matching ImMemchr kernel.
 
-      if (index1 < SIMD_LENGTH)
-        return ptr + index1;
+typedef const void* (*ImMemmemFunc)(const void* haystack, size_t count, const void* needle, size_t needle_len);
 
-      if (index2 < SIMD_LENGTH)
-        return ptr + SIMD_LENGTH + index2;
+// Compares needles of 3 to 16 bytes with two overlapping loads, the first and last byte already matched
+static inline bool ImMemmemEqualShort(const unsigned char* candidate, const unsigned char* needle, size_t needle_len)
+{
+  if (needle_len >= 8)
+  {
+    uint64_t c0, c1, n0, n1;
+    memcpy(&c0, candidate, 8);
+    memcpy(&c1, candidate + needle_len - 8, 8);
+    memcpy(&n0, needle, 8);
+    memcpy(&n1, needle + needle_len - 8, 8);
+    return ((c0 ^ n0) | (c1 ^ n1)) == 0;
+  }
 
-      if (ptr <= end - IMGUI_PREFECTH_LENGTH)
-        _mm_prefetch((const char*)(ptr + IMGUI_PREFECTH_LENGTH), _MM_HINT_T0);
-    }
+  if (needle_len >= 4)
+  {
+    uint32_t c0, c1, n0, n1;
+    memcpy(&c0, candidate, 4);
+    memcpy(&c1, candidate + needle_len - 4, 4);
+    memcpy(&n0, needle, 4);
+    memcpy(&n1, needle + needle_len - 4, 4);
+    return ((c0 ^ n0) | (c1 ^ n1)) == 0;
   }
 
-  for (; ptr < end; ptr++)
+  return candidate[1] == needle[1];
+}
+
+static inline bool ImMemmemVerify(const unsigned char* candidate, const unsigned char* needle, size_t needle_len)
+{
+  if (needle_len <= 2)
+    return true;
+  if (needle_len <= 16)
+    return ImMemmemEqualShort(candidate, needle, needle_len);
+
+  return memcmp(candidate + 1, needle + 1, needle_len - 2) == 0;
+}
+
+// Verifies the candidates of one block in order, mask bit i stands for block + i
+static inline const void* ImMemmemResolve(const unsigned char* block, uint64_t mask, const unsigned char* needle, size_t needle_len)
+{
+  for (; mask; mask &= mask - 1)
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    const unsigned char* candidate = block + ImCountTrailingZeros64(mask);
+
+    if (ImMemmemVerify(candidate, needle, needle_len))
+      return (const void*)candidate;
   }
 
   return nullptr;
 }
 
-const void* ImMemchrSSE4_2_UNROLL(const void* buf, int val, size_t count)
+// memchr on the first byte, then memcmp on the rest. Also handles haystacks shorter than one vector.
+const void* ImMemmemCSTD(const void* haystack, size_t count, const void* needle, size_t needle_len)
 {
-  const size_t SIMD_LENGTH = 16;
-  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  const unsigned char* ptr = (const unsigned char*)haystack;
+  const unsigned char* pattern = (const unsigned char*)needle;
 
-  const unsigned char* ptr = (const unsigned char*)buf;
-  const unsigned char* end = ptr + count;
-  const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char ch = (const unsigned char)val;
+  if (needle_len == 0)
+    return haystack;
+  if (needle_len > count)
+    return nullptr;
 
-  if (ptr <= align_end)
+  const unsigned char* end = ptr + count - (needle_len - 1);
+
+  while (ptr < end && (ptr = (const unsigned char*)memchr(ptr, pattern[0], end - ptr)))
   {
-    const __m128i target = _mm_set1_epi8(ch);
+    if (memcmp(ptr + 1, pattern + 1, needle_len - 1) == 0)
+      return (const void*)ptr;
 
-    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
-    {
-      __m128i chunk = _mm_lddqu_si128((const __m128i*)ptr);
-      int index = _mm_cmpistri(chunk, target, _SIDD_CMP_EQUAL_EACH);
+    ptr++;
+  }
+
+  return nullptr;
+}
+
+IMGUI_TARGET_AVX512
+static inline uint64_t ImMemmemMaskAVX512(const unsigned char* ptr, size_t last_offset, const __m512i& first, const __m512i& last)
+{
+  __mmask64 first_mask = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const __m512i*)ptr), first);
+  return _mm512_mask_cmpeq_epi8_mask(first_mask, _mm512_loadu_si512((const __m512i*)(ptr + last_offset)), last);
+}
+
+IMGUI_TARGET_AVX2
+static inline uint64_t ImMemmemMaskAVX2(const unsigned char* ptr, size_t last_offset, const __m256i& first, const __m256i& last)
+{
+  __m256i first_eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)ptr), first);
+  __m256i last_eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(ptr + last_offset)), last);
+  return (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(first_eq, last_eq));
+}
+
+IMGUI_TARGET_SSE2
+static inline uint64_t ImMemmemMaskSSE(const unsigned char* ptr, size_t last_offset, const __m128i& first, const __m128i& last)
+{
+  __m128i first_eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)ptr), first);
+  __m128i last_eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(ptr + last_offset)), last);
+  return (uint32_t)_mm_movemask_epi8(_mm_and_si128(first_eq, last_eq));
+}
+
+template <int UNROLL, bool PREFETCH, ImMemchrFunc MemchrFunc>
+IMGUI_TARGET_AVX512
+const void* ImMemmemAVX512_Impl(const void* haystack, size_t count, const void* needle, size_t needle_len)
+{
+  const size_t SIMD_LENGTH = 64;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
+
+  const unsigned char* ptr = (const unsigned char*)haystack;
+  const unsigned char* pattern = (const unsigned char*)needle;
+
+  if (needle_len == 0)
+    return haystack;
+  if (needle_len > count)
+    return nullptr;
+  if (needle_len == 1)
+    return MemchrFunc(haystack, pattern[0], count);
+
+  // Candidates start in [ptr, end), the shifted load of the last needle byte ends at the haystack end
+  const size_t last_offset = needle_len - 1;
+
+  if (count - last_offset < SIMD_LENGTH)
+    return ImMemmemCSTD(haystack, count, needle, needle_len);
+
+  const unsigned char* end = ptr + count - last_offset;
+  const unsigned char* align_end = end - SIMD_LENGTH;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
+  const __m512i first = _mm512_set1_epi8(pattern[0]);
+  const __m512i last = _mm512_set1_epi8(pattern[last_offset]);
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_AVX512), ptr, end) : ImPrefetcher();
 
-      if (index < SIMD_LENGTH)
-        return ptr + index;
+  for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
+  {
+    uint64_t masks[UNROLL];
+    uint64_t any = 0;
 
-      ptr = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
+    for (int i = 0; i < UNROLL; i++)
+    {
+      masks[i] = ImMemmemMaskAVX512(ptr + SIMD_LENGTH * i, last_offset, first, last);
+      any |= masks[i];
     }
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH * 2)
+    if (any)
     {
-      __m128i chunk1 = _mm_load_si128((const __m128i*)ptr);
-      __m128i chunk2 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH));
-
-      int index1 = _mm_cmpistri(chunk1, target, _SIDD_CMP_EQUAL_EACH);
-      int index2 = _mm_cmpistri(chunk2, target, _SIDD_CMP_EQUAL_EACH);
-
-      if (index1 < SIMD_LENGTH)
-        return ptr + index1;
+      for (int i = 0; i < UNROLL; i++)
+      {
+        if (const void* match = ImMemmemResolve(ptr + SIMD_LENGTH * i, masks[i], pattern, needle_len))
+          return match;
+      }
+    }
 
-      if (index2 < SIMD_LENGTH)
-        return ptr + SIMD_LENGTH + index2;
+    if constexpr (PREFETCH)
+    {
+      prefetcher(ptr);
     }
   }
 
-  for (; ptr < end; ptr++)
+  for (; ptr <= align_end; ptr += SIMD_LENGTH)
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    if (const void* match = ImMemmemResolve(ptr, ImMemmemMaskAVX512(ptr, last_offset, first, last), pattern, needle_len))
+      return match;
   }
 
+  // The last block overlaps the previous one, its candidates before ptr were already rejected
+  if (ptr < end)
+    return ImMemmemResolve(align_end, ImMemmemMaskAVX512(align_end, last_offset, first, last) & (~0ull << (ptr - align_end)), pattern, needle_len);
+
   return nullptr;
 }
 
-const void* ImMemchrSSE4_2_PREFETCH(const void* buf, int val, size_t count)
+template <int UNROLL, bool PREFETCH, ImMemchrFunc MemchrFunc>
+IMGUI_TARGET_AVX2
+const void* ImMemmemAVX2_Impl(const void* haystack, size_t count, const void* needle, size_t needle_len)
 {
-  const size_t SIMD_LENGTH = 16;
-  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  const size_t SIMD_LENGTH = 32;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
 
-  const unsigned char* ptr = (const unsigned char*)buf;
-  const unsigned char* end = ptr + count;
+  const unsigned char* ptr = (const unsigned char*)haystack;
+  const unsigned char* pattern = (const unsigned char*)needle;
+
+  if (needle_len == 0)
+    return haystack;
+  if (needle_len > count)
+    return nullptr;
+  if (needle_len == 1)
+    return MemchrFunc(haystack, pattern[0], count);
+
+  const size_t last_offset = needle_len - 1;
+
+  if (count - last_offset < SIMD_LENGTH)
+    return ImMemmemCSTD(haystack, count, needle, needle_len);
+
+  const unsigned char* end = ptr + count - last_offset;
   const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char ch = (const unsigned char)val;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
+  const __m256i first = _mm256_set1_epi8(pattern[0]);
+  const __m256i last = _mm256_set1_epi8(pattern[last_offset]);
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_AVX2), ptr, end) : ImPrefetcher();
 
-  if (ptr <= align_end)
+  for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
   {
-    const __m128i target = _mm_set1_epi8(ch);
+    uint64_t masks[UNROLL];
+    uint64_t any = 0;
 
-    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+    for (int i = 0; i < UNROLL; i++)
     {
-      __m128i chunk = _mm_lddqu_si128((const __m128i*)ptr);
-      int index = _mm_cmpistri(chunk, target, _SIDD_CMP_EQUAL_EACH);
-
-      if (index < SIMD_LENGTH)
-        return ptr + index;
-
-      ptr = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
+      masks[i] = ImMemmemMaskAVX2(ptr + SIMD_LENGTH * i, last_offset, first, last);
+      any |= masks[i];
     }
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    if (any)
     {
-      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
-      int index = _mm_cmpistri(chunk, target, _SIDD_CMP_EQUAL_EACH);
-
-      if (index < SIMD_LENGTH)
-        return ptr + index;
+      for (int i = 0; i < UNROLL; i++)
+      {
+        if (const void* match = ImMemmemResolve(ptr + SIMD_LENGTH * i, masks[i], pattern, needle_len))
+          return match;
+      }
+    }
 
-      if (ptr <= end - IMGUI_PREFECTH_LENGTH)
-        _mm_prefetch((const char*)(ptr + IMGUI_PREFECTH_LENGTH), _MM_HINT_T0);
+    if constexpr (PREFETCH)
+    {
+      prefetcher(ptr);
     }
   }
 
-  for (; ptr < end; ptr++)
+  for (; ptr <= align_end; ptr += SIMD_LENGTH)
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    if (const void* match = ImMemmemResolve(ptr, ImMemmemMaskAVX2(ptr, last_offset, first, last), pattern, needle_len))
+      return match;
   }
 
+  if (ptr < end)
+    return ImMemmemResolve(align_end, ImMemmemMaskAVX2(align_end, last_offset, first, last) & (~0ull << (ptr - align_end)), pattern, needle_len);
+
   return nullptr;
 }
 
-const void* ImMemchrSSE4_2(const void* buf, int val, size_t count)
+template <int UNROLL, bool PREFETCH, ImMemchrFunc MemchrFunc>
+IMGUI_TARGET_SSE2
+const void* ImMemmemSSE_Impl(const void* haystack, size_t count, const void* needle, size_t needle_len)
 {
   const size_t SIMD_LENGTH = 16;
-  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  const size_t SIMD_UNROLLED_LENGTH = SIMD_LENGTH * UNROLL;
 
-  const unsigned char* ptr = (const unsigned char*)buf;
-  const unsigned char* end = ptr + count;
+  const unsigned char* ptr = (const unsigned char*)haystack;
+  const unsigned char* pattern = (const unsigned char*)needle;
+
+  if (needle_len == 0)
+    return haystack;
+  if (needle_len > count)
+    return nullptr;
+  if (needle_len == 1)
+    return MemchrFunc(haystack, pattern[0], count);
+
+  const size_t last_offset = needle_len - 1;
+
+  if (count - last_offset < SIMD_LENGTH)
+    return ImMemmemCSTD(haystack, count, needle, needle_len);
+
+  const unsigned char* end = ptr + count - last_offset;
   const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char ch = (const unsigned char)val;
+  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
+  const __m128i first = _mm_set1_epi8((char)pattern[0]);
+  const __m128i last = _mm_set1_epi8((char)pattern[last_offset]);
+  ImPrefetcher prefetcher = PREFETCH ? ImPrefetcher(ImGetPrefetchSettings(ImMemchrIsa_SSE), ptr, end) : ImPrefetcher();
 
-  if (ptr <= align_end)
+  for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
   {
-    const __m128i target = _mm_set1_epi8(ch);
+    uint64_t masks[UNROLL];
+    uint64_t any = 0;
 
-    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
+    for (int i = 0; i < UNROLL; i++)
     {
-      __m128i chunk = _mm_lddqu_si128((const __m128i*)ptr);
-      int index = _mm_cmpistri(chunk, target, _SIDD_CMP_EQUAL_EACH);
-
-      if (index < SIMD_LENGTH)
-        return ptr + index;
-
-      ptr = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
+      masks[i] = ImMemmemMaskSSE(ptr + SIMD_LENGTH * i, last_offset, first, last);
+      any |= masks[i];
     }
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH)
+    if (any)
     {
-      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
-      int index = _mm_cmpistri(chunk, target, _SIDD_CMP_EQUAL_EACH);
+      for (int i = 0; i < UNROLL; i++)
+      {
+        if (const void* match = ImMemmemResolve(ptr + SIMD_LENGTH * i, masks[i], pattern, needle_len))
+          return match;
+      }
+    }
 
-      if (index < SIMD_LENGTH)
-        return ptr + index;
+    if constexpr (PREFETCH)
+    {
+      prefetcher(ptr);
     }
   }
 
-  for (; ptr < end; ptr++)
+  for (; ptr <= align_end; ptr += SIMD_LENGTH)
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    if (const void* match = ImMemmemResolve(ptr, ImMemmemMaskSSE(ptr, last_offset, first, last), pattern, needle_len))
+      return match;
   }
 
+  if (ptr < end)
+    return ImMemmemResolve(align_end, ImMemmemMaskSSE(align_end, last_offset, first, last) & (~0ull << (ptr - align_end)), pattern, needle_len);
+
   return nullptr;
 }
 
+const void* ImMemmemAVX512_PREFETCH(const void* haystack, size_t count, const void* needle, size_t needle_len)      { return ImMemmemAVX512_Impl<1, true, ImMemchrAVX512_PREFETCH>(haystack, count, needle, needle_len); }
+const void* ImMemmemAVX512(const void* haystack, size_t count, const void* needle, size_t needle_len)               { return ImMemmemAVX512_Impl<1, false, ImMemchrAVX512>(haystack, count, needle, needle_len); }
 
-const void* ImMemchrSSE_UNROLL_PREFETCH(const void* buf, int val, size_t count)
-{
-  const size_t SIMD_LENGTH = 16;
-  const size_t SIMD_UNROLLED_LENGTH = 16 * 4;
-  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+const void* ImMemmemAVX2_UNROLL_PREFETCH(const void* haystack, size_t count, const void* needle, size_t needle_len) { return ImMemmemAVX2_Impl<4, true, ImMemchrAVX2_UNROLL_PREFETCH>(haystack, count, needle, needle_len); }
+const void* ImMemmemAVX2_UNROLL(const void* haystack, size_t count, const void* needle, size_t needle_len)          { return ImMemmemAVX2_Impl<4, false, ImMemchrAVX2_UNROLL>(haystack, count, needle, needle_len); }
+const void* ImMemmemAVX2_PREFETCH(const void* haystack, size_t count, const void* needle, size_t needle_len)        { return ImMemmemAVX2_Impl<1, true, ImMemchrAVX2_PREFETCH>(haystack, count, needle, needle_len); }
+const void* ImMemmemAVX2(const void* haystack, size_t count, const void* needle, size_t needle_len)                 { return ImMemmemAVX2_Impl<1, false, ImMemchrAVX2>(haystack, count, needle, needle_len); }
 
-  const unsigned char* ptr = (const unsigned char*)buf;
-  const unsigned char* end = ptr + count;
-  const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
-  const unsigned char ch = (const unsigned char)val;
+const void* ImMemmemSSE_UNROLL_PREFETCH(const void* haystack, size_t count, const void* needle, size_t needle_len)  { return ImMemmemSSE_Impl<4, true, ImMemchrSSE_UNROLL_PREFETCH>(haystack, count, needle, needle_len); }
+const void* ImMemmemSSE_UNROLL(const void* haystack, size_t count, const void* needle, size_t needle_len)           { return ImMemmemSSE_Impl<4, false, ImMemchrSSE_UNROLL>(haystack, count, needle, needle_len); }
+const void* ImMemmemSSE_PREFETCH(const void* haystack, size_t count, const void* needle, size_t needle_len)         { return ImMemmemSSE_Impl<1, true, ImMemchrSSE_PREFETCH>(haystack, count, needle, needle_len); }
+const void* ImMemmemSSE(const void* haystack, size_t count, const void* needle, size_t needle_len)                  { return ImMemmemSSE_Impl<1, false, ImMemchrSSE>(haystack, count, needle, needle_len); }
 
-  if (ptr <= align_end)
-  {
-    const __m128i target = _mm_set1_epi8(ch);
+const void* ImMemmemResolve(const void* haystack, size_t count, const void* needle, size_t needle_len);
 
-    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
-    {
-      __m128i chunk = _mm_loadu_si128((const __m128i*)ptr);
-      int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+static std::atomic<ImMemmemFunc> ImMemmemImpl{ ImMemmemResolve };
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+const void* ImMemmemResolve(const void* haystack, size_t count, const void* needle, size_t needle_len)
+{
+  ImMemmemFunc func = ImMemmemCSTD;
 
-      ptr = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
-    }
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512))
+    func = ImMemmemAVX512;
+  else if (ImHasCpuFeatures(ImMemchrRequiredAVX2))
+    func = ImMemmemAVX2_UNROLL;
+  else if (ImHasCpuFeatures(ImMemchrRequiredSSE2))
+    func = ImMemmemSSE_UNROLL;
 
-    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
-    {
-      __m128i chunk1 = _mm_load_si128((const __m128i*)ptr);
-      __m128i chunk2 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH));
-      __m128i chunk3 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * 2));
-      __m128i chunk4 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * 3));
+  ImMemmemImpl.store(func, std::memory_order_relaxed);
+  return func(haystack, count, needle, needle_len);
+}
 
-      int mask1 = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk1, target));
-      int mask2 = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk2, target));
-      int mask3 = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk3, target));
-      int mask4 = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk4, target));
+const void* ImMemmem(const void* haystack, size_t count, const void* needle, size_t needle_len)
+{
+  return ImMemmemImpl.load(std::memory_order_relaxed)(haystack, count, needle, needle_len);
+}
 
-      if (mask1)
-        return (const void*)(ptr + _tzcnt_u32(mask1));
-      else if (mask2)
-        return (const void*)(ptr + SIMD_LENGTH + _tzcnt_u32(mask2));
-      else if (mask3)
-        return (const void*)(ptr + SIMD_LENGTH * 2 + _tzcnt_u32(mask3));
-      else if (mask4)
-        return (const void*)(ptr + SIMD_LENGTH * 3 + _tzcnt_u32(mask4));
+#pragma endregion
+// MEMMEM
 
-      if (ptr <= end - IMGUI_PREFECTH_LENGTH)
-        _mm_prefetch((const char*)(ptr + IMGUI_PREFECTH_LENGTH), _MM_HINT_T0);
-    }
+#pragma region BYTE_SET
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH)
-    {
-      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
-      int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+// ImMemchrSet returns the first byte that belongs to a set, ImMemcspn the length of the prefix without
+// set bytes and ImMemspn the length of the prefix made only of set bytes.
+// Sets of up to 3 bytes OR one cmpeq per byte. Larger sets look up both nibbles with pshufb: the entry
+// of the low nibble holds one bit per high nibble, and a byte matches when the bit of its high nibble
+// is set. The AVX-512 VBMI kernel looks up the 256-bit bitmap directly with vpermb.
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+// Precompiled byte set, build it once and pass it to every call
+struct ImByteSet
+{
+  unsigned char bitmap[32];      // bit (ch & 7) of bitmap[ch >> 3]
+  unsigned char nibble_low[16];  // bit (ch >> 4) of entry (ch & 15), bytes 0x00-0x7F
+  unsigned char nibble_high[16]; // bit ((ch >> 4) - 8) of entry (ch & 15), bytes 0x80-0xFF
+  unsigned char literals[3];     // first 3 bytes, unused slots repeat the first byte
+  int count;
 
-      if (ptr <= end - IMGUI_PREFECTH_LENGTH)
-        _mm_prefetch((const char*)(ptr + IMGUI_PREFECTH_LENGTH), _MM_HINT_T0);
-    }
+  ImByteSet()
+  {
+    memset(this, 0, sizeof(*this));
   }
 
-  for (; ptr < end; ptr++)
+  ImByteSet(const void* bytes, size_t size) : ImByteSet()
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    for (size_t i = 0; i < size; i++)
+      Add(((const unsigned char*)bytes)[i]);
   }
 
-  return nullptr;
-}
+  bool Contains(unsigned char ch) const
+  {
+    return (bitmap[ch >> 3] >> (ch & 7)) & 1;
+  }
 
-const void* ImMemchrSSE_UNROLL(const void* buf, int val, size_t count)
-{
-  const size_t SIMD_LENGTH = 16;
-  const size_t SIMD_UNROLLED_LENGTH = 16 * 4;
-  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  void Add(unsigned char ch)
+  {
+    if (Contains(ch))
+      return;
+
+    bitmap[ch >> 3] |= (unsigned char)(1 << (ch & 7));
 
+    if (ch < 0x80)
+      nibble_low[ch & 15] |= (unsigned char)(1 << (ch >> 4));
+    else
+      nibble_high[ch & 15] |= (unsigned char)(1 << ((ch >> 4) - 8));
+
+    if (count == 0)
+      literals[0] = literals[1] = literals[2] = ch;
+    else if (count < 3)
+      literals[count] = ch;
+
+    count++;
+  }
+};
+
+typedef const void* (*ImMemchrSetFunc)(const void* buf, size_t count, const ImByteSet& set);
+typedef size_t (*ImMemspnFunc)(const void* buf, size_t count, const ImByteSet& set);
+
+template <bool IN_SET>
+size_t ImMemchrSetScalar_Impl(const void* buf, size_t count, const ImByteSet& set)
+{
   const unsigned char* ptr = (const unsigned char*)buf;
-  const unsigned char* end = ptr + count;
-  const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char* align_unroll_end = end - SIMD_UNROLLED_LENGTH;
-  const unsigned char ch = (const unsigned char)val;
 
-  if (ptr <= align_end) 
+  for (size_t i = 0; i < count; i++)
   {
-    const __m128i target = _mm_set1_epi8(ch);
+    if (set.Contains(ptr[i]) == IN_SET)
+      return i;
+  }
 
-    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
-    {
-      __m128i chunk = _mm_loadu_si128((const __m128i*)ptr);
-      int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+  return count;
+}
 
-      
+// tables holds the 3 broadcast literals, or the bitmap and the bit of each (ch & 7)
+template <bool LITERALS>
+IMGUI_TARGET_AVX512_VBMI
+static inline uint64_t ImByteSetMaskAVX512_VBMI(__m512i chunk, const __m512i (&tables)[3])
+{
+  if constexpr (LITERALS)
+  {
+    return _mm512_cmpeq_epi8_mask(chunk, tables[0]) | _mm512_cmpeq_epi8_mask(chunk, tables[1]) | _mm512_cmpeq_epi8_mask(chunk, tables[2]);
+  }
+  else
+  {
+    __m512i index = _mm512_and_si512(_mm512_srli_epi16(chunk, 3), _mm512_set1_epi8(0x1F));
+    __m512i bits = _mm512_permutexvar_epi8(index, tables[0]);
+    __m512i bit = _mm512_shuffle_epi8(tables[1], _mm512_and_si512(chunk, _mm512_set1_epi8(7)));
+    return _mm512_test_epi8_mask(bits, bit);
+  }
+}
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+// tables holds the 3 broadcast literals, or the low and high half nibble tables and the bit of each high nibble
+template <bool LITERALS>
+IMGUI_TARGET_AVX2
+static inline uint64_t ImByteSetMaskAVX2(__m256i chunk, const __m256i (&tables)[3])
+{
+  if constexpr (LITERALS)
+  {
+    __m256i eq = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, tables[0]), _mm256_or_si256(_mm256_cmpeq_epi8(chunk, tables[1]), _mm256_cmpeq_epi8(chunk, tables[2])));
+    return (uint32_t)_mm256_movemask_epi8(eq);
+  }
+  else
+  {
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_and_si256(chunk, nibble_mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble_mask);
+    __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(tables[0], low), _mm256_shuffle_epi8(tables[1], low), chunk);
+    __m256i bit = _mm256_shuffle_epi8(tables[2], high);
+    return ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), _mm256_setzero_si256())) & 0xFFFFFFFFull;
+  }
+}
 
-      ptr = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
-    }
+template <bool LITERALS>
+IMGUI_TARGET_SSSE3
+static inline uint64_t ImByteSetMaskSSSE3(__m128i chunk, const __m128i (&tables)[3])
+{
+  if constexpr (LITERALS)
+  {
+    __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(chunk, tables[0]), _mm_or_si128(_mm_cmpeq_epi8(chunk, tables[1]), _mm_cmpeq_epi8(chunk, tables[2])));
+    return (uint32_t)_mm_movemask_epi8(eq);
+  }
+  else
+  {
+    // No blendv before SSE4.1, the sign of each byte selects the table half
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+    __m128i low = _mm_and_si128(chunk, nibble_mask);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble_mask);
+    __m128i sign = _mm_cmplt_epi8(chunk, _mm_setzero_si128());
+    __m128i row = _mm_or_si128(_mm_andnot_si128(sign, _mm_shuffle_epi8(tables[0], low)), _mm_and_si128(sign, _mm_shuffle_epi8(tables[1], low)));
+    __m128i bit = _mm_shuffle_epi8(tables[2], high);
+    return ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), _mm_setzero_si128())) & 0xFFFFull;
+  }
+}
 
-    for (; ptr <= align_unroll_end; ptr += SIMD_UNROLLED_LENGTH)
-    {
-      __m128i chunk1 = _mm_load_si128((const __m128i*)ptr);
-      __m128i chunk2 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH));
-      __m128i chunk3 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * 2));
-      __m128i chunk4 = _mm_load_si128((const __m128i*)(ptr + SIMD_LENGTH * 3));
+template <bool IN_SET, bool LITERALS>
+IMGUI_TARGET_AVX512_VBMI
+size_t ImMemchrSetAVX512_VBMI_Scan(const void* buf, size_t count, const ImByteSet& set)
+{
+  const size_t SIMD_LENGTH = 64;
+  const uint64_t LANE_MASK = ~0ull;
 
-      int mask1 = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk1, target));
-      int mask2 = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk2, target));
-      int mask3 = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk3, target));
-      int mask4 = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk4, target));
+  const unsigned char* begin = (const unsigned char*)buf;
+  const unsigned char* ptr = begin;
+  const unsigned char* end = begin + count;
+  const unsigned char* align_end = end - SIMD_LENGTH;
 
-      if (mask1)
-        return (const void*)(ptr + _tzcnt_u32(mask1));
-      else if (mask2)
-        return (const void*)(ptr + SIMD_LENGTH + _tzcnt_u32(mask2));
-      else if (mask3)
-        return (const void*)(ptr + SIMD_LENGTH * 2 + _tzcnt_u32(mask3));
-      else if (mask4)
-        return (const void*)(ptr + SIMD_LENGTH * 3 + _tzcnt_u32(mask4));
-    }
+  __m512i tables[3];
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH)
-    {
-      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
-      int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+  if constexpr (LITERALS)
+  {
+    for (int i = 0; i < 3; i++)
+      tables[i] = _mm512_set1_epi8((char)set.literals[i]);
+  }
+  else
+  {
+    tables[0] = _mm512_zextsi256_si512(_mm256_loadu_si256((const __m256i*)set.bitmap));
+    tables[1] = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    tables[2] = _mm512_setzero_si512();
+  }
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
-    }
+  for (; ptr <= align_end; ptr += SIMD_LENGTH)
+  {
+    uint64_t mask = ImByteSetMaskAVX512_VBMI<LITERALS>(_mm512_loadu_si512((const __m512i*)ptr), tables);
+
+    if constexpr (!IN_SET)
+      mask ^= LANE_MASK;
+
+    if (mask)
+      return (ptr - begin) + ImCountTrailingZeros64(mask);
   }
 
-  for (; ptr < end; ptr++) 
+  // The last block overlaps the previous one, its lanes before ptr were already checked
+  if (ptr < end)
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    uint64_t mask = ImByteSetMaskAVX512_VBMI<LITERALS>(_mm512_loadu_si512((const __m512i*)align_end), tables);
+
+    if constexpr (!IN_SET)
+      mask ^= LANE_MASK;
+
+    mask &= ~0ull << (ptr - align_end);
+
+    if (mask)
+      return (align_end - begin) + ImCountTrailingZeros64(mask);
   }
 
-  return nullptr;
+  return count;
 }
 
-const void* ImMemchrSSE_PREFETCH(const void* buf, int val, size_t count)
+template <bool IN_SET, bool LITERALS>
+IMGUI_TARGET_AVX2
+size_t ImMemchrSetAVX2_Scan(const void* buf, size_t count, const ImByteSet& set)
 {
-  const size_t SIMD_LENGTH = 16;
-  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  const size_t SIMD_LENGTH = 32;
+  const uint64_t LANE_MASK = 0xFFFFFFFFull;
 
-  const unsigned char* ptr = (const unsigned char*)buf;
-  const unsigned char* end = ptr + count;
+  const unsigned char* begin = (const unsigned char*)buf;
+  const unsigned char* ptr = begin;
+  const unsigned char* end = begin + count;
   const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char ch = (const unsigned char)val;
 
-  if (ptr <= align_end)
+  __m256i tables[3];
+
+  if constexpr (LITERALS)
   {
-    const __m128i target = _mm_set1_epi8(ch);
+    for (int i = 0; i < 3; i++)
+      tables[i] = _mm256_set1_epi8((char)set.literals[i]);
+  }
+  else
+  {
+    tables[0] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)set.nibble_low));
+    tables[1] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)set.nibble_high));
+    tables[2] = _mm256_setr_epi8(
+      1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+      1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  }
 
-    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
-    {
-      __m128i chunk = _mm_lddqu_si128((const __m128i*)ptr);
-      int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+  for (; ptr <= align_end; ptr += SIMD_LENGTH)
+  {
+    uint64_t mask = ImByteSetMaskAVX2<LITERALS>(_mm256_loadu_si256((const __m256i*)ptr), tables);
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+    if constexpr (!IN_SET)
+      mask ^= LANE_MASK;
 
-      ptr = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
-    }
+    if (mask)
+      return (ptr - begin) + ImCountTrailingZeros64(mask);
+  }
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH)
-    {
-      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
-      int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+  if (ptr < end)
+  {
+    uint64_t mask = ImByteSetMaskAVX2<LITERALS>(_mm256_loadu_si256((const __m256i*)align_end), tables);
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+    if constexpr (!IN_SET)
+      mask ^= LANE_MASK;
 
-      if (ptr <= end - IMGUI_PREFECTH_LENGTH)
-        _mm_prefetch((const char*)(ptr + IMGUI_PREFECTH_LENGTH), _MM_HINT_T0);
-    }
-  }
+    mask &= ~0ull << (ptr - align_end);
 
-  for (; ptr < end; ptr++)
-  {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    if (mask)
+      return (align_end - begin) + ImCountTrailingZeros64(mask);
   }
 
-  return nullptr;
+  return count;
 }
 
-const void* ImMemchrSSE(const void* buf, int val, size_t count)
+template <bool IN_SET, bool LITERALS>
+IMGUI_TARGET_SSSE3
+size_t ImMemchrSetSSSE3_Scan(const void* buf, size_t count, const ImByteSet& set)
 {
   const size_t SIMD_LENGTH = 16;
-  const size_t SIMD_LENGTH_MASK = SIMD_LENGTH - 1;
+  const uint64_t LANE_MASK = 0xFFFFull;
 
-  const unsigned char* ptr = (const unsigned char*)buf;
-  const unsigned char* end = ptr + count;
+  const unsigned char* begin = (const unsigned char*)buf;
+  const unsigned char* ptr = begin;
+  const unsigned char* end = begin + count;
   const unsigned char* align_end = end - SIMD_LENGTH;
-  const unsigned char ch = (const unsigned char)val;
-
-  if (ptr <= align_end)
-  {
-    const __m128i target = _mm_set1_epi8(ch);
 
-    if ((uintptr_t)ptr & SIMD_LENGTH_MASK)
-    {
-      __m128i chunk = _mm_lddqu_si128((const __m128i*)ptr);
-      int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+  __m128i tables[3];
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
+  if constexpr (LITERALS)
+  {
+    for (int i = 0; i < 3; i++)
+      tables[i] = _mm_set1_epi8((char)set.literals[i]);
+  }
+  else
+  {
+    tables[0] = _mm_loadu_si128((const __m128i*)set.nibble_low);
+    tables[1] = _mm_loadu_si128((const __m128i*)set.nibble_high);
+    tables[2] = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  }
 
-      ptr = (const unsigned char*)(((uintptr_t)ptr + SIMD_LENGTH_MASK) & ~SIMD_LENGTH_MASK);
-    }
+  for (; ptr <= align_end; ptr += SIMD_LENGTH)
+  {
+    uint64_t mask = ImByteSetMaskSSSE3<LITERALS>(_mm_loadu_si128((const __m128i*)ptr), tables);
 
-    for (; ptr <= align_end; ptr += SIMD_LENGTH)
-    {
-      __m128i chunk = _mm_load_si128((const __m128i*)ptr);
-      int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+    if constexpr (!IN_SET)
+      mask ^= LANE_MASK;
 
-      if (mask)
-        return (const void*)(ptr + _tzcnt_u32(mask));
-    }
+    if (mask)
+      return (ptr - begin) + ImCountTrailingZeros64(mask);
   }
 
-  for (; ptr < end; ptr++)
+  if (ptr < end)
   {
-    if (*ptr == ch)
-      return (const void*)(ptr);
+    uint64_t mask = ImByteSetMaskSSSE3<LITERALS>(_mm_loadu_si128((const __m128i*)align_end), tables);
+
+    if constexpr (!IN_SET)
+      mask ^= LANE_MASK;
+
+    mask &= ~0ull << (ptr - align_end);
+
+    if (mask)
+      return (align_end - begin) + ImCountTrailingZeros64(mask);
   }
 
-  return nullptr;
+  return count;
 }
 
-const void* ImMemchrCSTD(const void* buf, int val, size_t count)
+// Returns the offset of the first byte whose membership equals IN_SET, or count
+template <bool IN_SET>
+size_t ImMemchrSetAVX512_VBMI_Impl(const void* buf, size_t count, const ImByteSet& set)
 {
-  return memchr(buf, val, count);
+  if (count < 64 || set.count == 0)
+    return ImMemchrSetScalar_Impl<IN_SET>(buf, count, set);
+
+  return set.count <= 3 ? ImMemchrSetAVX512_VBMI_Scan<IN_SET, true>(buf, count, set) : ImMemchrSetAVX512_VBMI_Scan<IN_SET, false>(buf, count, set);
 }
 
+template <bool IN_SET>
+size_t ImMemchrSetAVX2_Impl(const void* buf, size_t count, const ImByteSet& set)
+{
+  if (count < 32 || set.count == 0)
+    return ImMemchrSetScalar_Impl<IN_SET>(buf, count, set);
 
-#if defined IMGUI_ENABLE_AVX512_IMMEMCHR
-const void* ImMemchr(const void* buf, int val, size_t count)
+  return set.count <= 3 ? ImMemchrSetAVX2_Scan<IN_SET, true>(buf, count, set) : ImMemchrSetAVX2_Scan<IN_SET, false>(buf, count, set);
+}
+
+template <bool IN_SET>
+size_t ImMemchrSetSSSE3_Impl(const void* buf, size_t count, const ImByteSet& set)
 {
-  return ImMemchrAVX512(buf, val, count);
+  if (count < 16 || set.count == 0)
+    return ImMemchrSetScalar_Impl<IN_SET>(buf, count, set);
+
+  return set.count <= 3 ? ImMemchrSetSSSE3_Scan<IN_SET, true>(buf, count, set) : ImMemchrSetSSSE3_Scan<IN_SET, false>(buf, count, set);
 }
-#elif defined IMGUI_ENABLE_AVX2_UNROLL_IMMEMCHR
-const void* ImMemchr(const void* buf, int val, size_t count)
+
+static inline const void* ImMemchrSetResult(const void* buf, size_t count, size_t offset)
 {
-  return ImMemchrAVX2_UNROLL(buf, val, count);
+  return offset < count ? (const void*)((const unsigned char*)buf + offset) : nullptr;
 }
-#elif defined IMGUI_ENABLE_AVX2_IMMEMCHR
-const void* ImMemchr(const void* buf, int val, size_t count)
+
+const void* ImMemchrSetAVX512_VBMI(const void* buf, size_t count, const ImByteSet& set) { return ImMemchrSetResult(buf, count, ImMemchrSetAVX512_VBMI_Impl<true>(buf, count, set)); }
+const void* ImMemchrSetAVX2(const void* buf, size_t count, const ImByteSet& set)        { return ImMemchrSetResult(buf, count, ImMemchrSetAVX2_Impl<true>(buf, count, set)); }
+const void* ImMemchrSetSSSE3(const void* buf, size_t count, const ImByteSet& set)       { return ImMemchrSetResult(buf, count, ImMemchrSetSSSE3_Impl<true>(buf, count, set)); }
+const void* ImMemchrSetScalar(const void* buf, size_t count, const ImByteSet& set)      { return ImMemchrSetResult(buf, count, ImMemchrSetScalar_Impl<true>(buf, count, set)); }
+
+size_t ImMemcspnAVX512_VBMI(const void* buf, size_t count, const ImByteSet& set)        { return ImMemchrSetAVX512_VBMI_Impl<true>(buf, count, set); }
+size_t ImMemcspnAVX2(const void* buf, size_t count, const ImByteSet& set)               { return ImMemchrSetAVX2_Impl<true>(buf, count, set); }
+size_t ImMemcspnSSSE3(const void* buf, size_t count, const ImByteSet& set)              { return ImMemchrSetSSSE3_Impl<true>(buf, count, set); }
+size_t ImMemcspnScalar(const void* buf, size_t count, const ImByteSet& set)             { return ImMemchrSetScalar_Impl<true>(buf, count, set); }
+
+size_t ImMemspnAVX512_VBMI(const void* buf, size_t count, const ImByteSet& set)         { return ImMemchrSetAVX512_VBMI_Impl<false>(buf, count, set); }
+size_t ImMemspnAVX2(const void* buf, size_t count, const ImByteSet& set)                { return ImMemchrSetAVX2_Impl<false>(buf, count, set); }
+size_t ImMemspnSSSE3(const void* buf, size_t count, const ImByteSet& set)               { return ImMemchrSetSSSE3_Impl<false>(buf, count, set); }
+size_t ImMemspnScalar(const void* buf, size_t count, const ImByteSet& set)              { return ImMemchrSetScalar_Impl<false>(buf, count, set); }
+
+const void* ImMemchrSetResolve(const void* buf, size_t count, const ImByteSet& set);
+
+static std::atomic<ImMemchrSetFunc> ImMemchrSetImpl{ ImMemchrSetResolve };
+
+const void* ImMemchrSetResolve(const void* buf, size_t count, const ImByteSet& set)
 {
-  return ImMemchrAVX2(buf, val, count);
+  ImMemchrSetFunc func = ImMemchrSetScalar;
+
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512_VBMI))
+    func = ImMemchrSetAVX512_VBMI;
+  else if (ImHasCpuFeatures(ImMemchrRequiredAVX2))
+    func = ImMemchrSetAVX2;
+  else if (ImHasCpuFeatures(ImMemchrRequiredSSSE3))
+    func = ImMemchrSetSSSE3;
+
+  ImMemchrSetImpl.store(func, std::memory_order_relaxed);
+  return func(buf, count, set);
 }
-#elif defined IMGUI_ENABLE_SSE_IMMEMCHR
-const void* ImMemchr(const void* buf, int val, size_t count)
+
+const void* ImMemchrSet(const void* buf, size_t count, const ImByteSet& set)
 {
-  return ImMemchrSSE(buf, val, count);
+  return ImMemchrSetImpl.load(std::memory_order_relaxed)(buf, count, set);
 }
-#else
-const void* ImMemchr(const void* buf, int val, size_t count)
+
+size_t ImMemcspnResolve(const void* buf, size_t count, const ImByteSet& set);
+
+static std::atomic<ImMemspnFunc> ImMemcspnImpl{ ImMemcspnResolve };
+
+size_t ImMemcspnResolve(const void* buf, size_t count, const ImByteSet& set)
 {
-  return ImMemchrCSTD(buf, val, count);
+  ImMemspnFunc func = ImMemcspnScalar;
+
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512_VBMI))
+    func = ImMemcspnAVX512_VBMI;
+  else if (ImHasCpuFeatures(ImMemchrRequiredAVX2))
+    func = ImMemcspnAVX2;
+  else if (ImHasCpuFeatures(ImMemchrRequiredSSSE3))
+    func = ImMemcspnSSSE3;
+
+  ImMemcspnImpl.store(func, std::memory_order_relaxed);
+  return func(buf, count, set);
+}
+
+size_t ImMemcspn(const void* buf, size_t count, const ImByteSet& set)
+{
+  return ImMemcspnImpl.load(std::memory_order_relaxed)(buf, count, set);
+}
+
+size_t ImMemspnResolve(const void* buf, size_t count, const ImByteSet& set);
+
+static std::atomic<ImMemspnFunc> ImMemspnImpl{ ImMemspnResolve };
+
+size_t ImMemspnResolve(const void* buf, size_t count, const ImByteSet& set)
+{
+  ImMemspnFunc func = ImMemspnScalar;
+
+  if (ImHasCpuFeatures(ImMemchrRequiredAVX512_VBMI))
+    func = ImMemspnAVX512_VBMI;
+  else if (ImHasCpuFeatures(ImMemchrRequiredAVX2))
+    func = ImMemspnAVX2;
+  else if (ImHasCpuFeatures(ImMemchrRequiredSSSE3))
+    func = ImMemspnSSSE3;
+
+  ImMemspnImpl.store(func, std::memory_order_relaxed);
+  return func(buf, count, set);
 }
-#endif
\ No newline at end of file
+
+size_t ImMemspn(const void* buf, size_t count, const ImByteSet& set)
+{
+  return ImMemspnImpl.load(std::memory_order_relaxed)(buf, count, set);
+}
+
+#pragma endregion
+// BYTE_SET
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <bit>
+#include <memory_resource>
+#include <new>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#define IMGUI_SMALL_PAGE_LENGTH 4096
+#define IMGUI_HUGE_PAGE_LENGTH (2 * 1024 * 1024)
+
+// Memory resource handing out whole pages from the OS, aligned to page_length. Nothing is written before use:
+// the OS supplies zeroed pages on first touch, so a buffer that is generated right away is written once.
+// Above IMGUI_SMALL_PAGE_LENGTH the pages are huge: explicit huge pages (MAP_HUGETLB, MEM_LARGE_PAGES) when the
+// system has them reserved or the process holds SeLockMemoryPrivilege, transparent huge pages through madvise
+// otherwise on Linux. Windows has no transparent huge pages, it falls back to small pages with the same alignment.
+// At IMGUI_SMALL_PAGE_LENGTH transparent huge pages are disabled for the range, so small pages are what is measured.
+class ImPageMemoryResource : public std::pmr::memory_resource
+{
+public:
+  explicit ImPageMemoryResource(size_t page_length = IMGUI_SMALL_PAGE_LENGTH)
+    : page_length(std::max<size_t>(std::bit_ceil(page_length), IMGUI_SMALL_PAGE_LENGTH))
+  {
+  }
+
+  size_t GetPageLength() const
+  {
+    return page_length;
+  }
+
+  bool IsHuge() const
+  {
+    return page_length > IMGUI_SMALL_PAGE_LENGTH;
+  }
+
+protected:
+  void* do_allocate(size_t bytes, size_t alignment) override
+  {
+    if (alignment > page_length)
+      throw std::bad_alloc();
+
+    const size_t length = GetAllocationLength(bytes);
+
+#if defined(_WIN32)
+    if (IsHuge() && GetLargePageMinimum() != 0 && length % GetLargePageMinimum() == 0)
+    {
+      if (void* p = VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE))
+        return p;
+    }
+
+    // Reserves enough to find an aligned address, then allocates there. Another thread may take the range in
+    // between, which is retried.
+    for (int attempt = 0; attempt < 8; attempt++)
+    {
+      char* reserved = (char*)VirtualAlloc(nullptr, length + page_length, MEM_RESERVE, PAGE_NOACCESS);
+      if (!reserved)
+        break;
+
+      char* aligned = (char*)(((uintptr_t)reserved + page_length - 1) & ~(uintptr_t)(page_length - 1));
+      VirtualFree(reserved, 0, MEM_RELEASE);
+
+      if (void* p = VirtualAlloc(aligned, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE))
+        return p;
+    }
+#else
+#if defined(MAP_HUGETLB)
+    if (IsHuge())
+    {
+      void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (p != MAP_FAILED)
+        return p;
+    }
+#endif
+
+    // Over-maps by one page, then unmaps the slack on both sides of the aligned range
+    const size_t slack = page_length - IMGUI_SMALL_PAGE_LENGTH;
+    char* mapped = (char*)mmap(nullptr, length + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (mapped != MAP_FAILED)
+    {
+      char* aligned = (char*)(((uintptr_t)mapped + page_length - 1) & ~(uintptr_t)(page_length - 1));
+
+      if (aligned > mapped)
+        munmap(mapped, size_t(aligned - mapped));
+      if (mapped + length + slack > aligned + length)
+        munmap(aligned + length, size_t(mapped + length + slack - (aligned + length)));
+
+#if defined(MADV_HUGEPAGE)
+      if (IsHuge())
+        madvise(aligned, length, MADV_HUGEPAGE);
+#endif
+#if defined(MADV_NOHUGEPAGE)
+      // Transparent huge pages set to "always" would otherwise back a small page buffer with huge pages
+      if (!IsHuge())
+        madvise(aligned, length, MADV_NOHUGEPAGE);
+#endif
+
+      return aligned;
+    }
+#endif
+
+    throw std::bad_alloc();
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t) override
+  {
+#if defined(_WIN32)
+    (void)bytes;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, GetAllocationLength(bytes));
+#endif
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+
+private:
+  size_t GetAllocationLength(size_t bytes) const
+  {
+    return (std::max<size_t>(bytes, 1) + page_length - 1) & ~(page_length - 1);
+  }
+
+private:
+  size_t page_length;
+};
+
+// Uninitialized char buffer taken from a memory resource, released to it on destruction
+class ImPageBuffer
+{
+public:
+  ImPageBuffer(size_t size, std::pmr::memory_resource* resource)
+    : resource(resource), data((char*)resource->allocate(size, alignof(std::max_align_t))), size(size)
+  {
+  }
+
+  ~ImPageBuffer()
+  {
+    resource->deallocate(data, size, alignof(std::max_align_t));
+  }
+
+  ImPageBuffer(const ImPageBuffer&) = delete;
+  ImPageBuffer& operator=(const ImPageBuffer&) = delete;
+
+  char* GetData() const
+  {
+    return data;
+  }
+
+  size_t GetSize() const
+  {
+    return size;
+  }
+
+private:
+  std::pmr::memory_resource* resource;
+  char* data;
+  size_t size;
+};
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "immemchr.h"
+
+// Below this length the parallel drivers call the serial kernel directly
+#define IMGUI_PARALLEL_MIN_LENGTH (4 * 1024 * 1024)
+
+// Work unit handed to the pool, sized to stay resident in L2 while it is scanned
+#define IMGUI_PARALLEL_CHUNK_LENGTH (1024 * 1024)
+
+// Granularity at which a worker re-checks the best match found by the others
+#define IMGUI_PARALLEL_CANCEL_LENGTH (64 * 1024)
+
+// Work-stealing pool. Every thread owns a deque of task indices: the owner pops from the front, so its part is
+// walked in ascending order, and idle threads steal from the back of the others. The calling thread takes part
+// in ParallelFor as thread 0.
+class ImThreadPool
+{
+public:
+  explicit ImThreadPool(unsigned int thread_count = std::max(1u, std::thread::hardware_concurrency()))
+    : thread_count(std::max(1u, thread_count)), queues(std::make_unique<Queue[]>(this->thread_count))
+  {
+    for (unsigned int i = 1; i < this->thread_count; i++)
+      workers.emplace_back([this, i] { WorkerLoop(i); });
+  }
+
+  ~ImThreadPool()
+  {
+    {
+      std::lock_guard lock(state_mutex);
+      stopping = true;
+    }
+
+    wake_cv.notify_all();
+
+    for (std::thread& worker : workers)
+      worker.join();
+  }
+
+  ImThreadPool(const ImThreadPool&) = delete;
+  ImThreadPool& operator=(const ImThreadPool&) = delete;
+
+  unsigned int GetThreadCount() const
+  {
+    return thread_count;
+  }
+
+  // Runs fn(index) for every index in [0, count) and returns once all of them are done
+  void ParallelFor(size_t count, std::function<void(size_t)> fn)
+  {
+    if (count == 0)
+      return;
+
+    std::lock_guard run_lock(run_mutex);
+
+    job = std::move(fn);
+    pending.store(count, std::memory_order_relaxed);
+
+    // Contiguous index ranges per thread keep neighbouring chunks on the same core
+    for (unsigned int i = 0; i < thread_count; i++)
+    {
+      const size_t first = count * i / thread_count;
+      const size_t last = count * (i + 1) / thread_count;
+
+      std::lock_guard lock(queues[i].mutex);
+      for (size_t index = first; index < last; index++)
+        queues[i].tasks.push_back(index);
+    }
+
+    {
+      std::lock_guard lock(state_mutex);
+      generation++;
+    }
+
+    wake_cv.notify_all();
+    RunTasks(0);
+
+    std::unique_lock lock(state_mutex);
+    done_cv.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+  }
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+  };
+
+  bool PopTask(unsigned int self, size_t& index)
+  {
+    {
+      Queue& own = queues[self];
+      std::lock_guard lock(own.mutex);
+
+      if (!own.tasks.empty())
+      {
+        index = own.tasks.front();
+        own.tasks.pop_front();
+        return true;
+      }
+    }
+
+    for (unsigned int i = 1; i < thread_count; i++)
+    {
+      Queue& victim = queues[(self + i) % thread_count];
+      std::lock_guard lock(victim.mutex);
+
+      if (!victim.tasks.empty())
+      {
+        index = victim.tasks.back();
+        victim.tasks.pop_back();
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  void RunTasks(unsigned int self)
+  {
+    size_t index;
+
+    while (PopTask(self, index))
+    {
+      job(index);
+
+      if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        {
+          std::lock_guard lock(state_mutex);
+        }
+
+        done_cv.notify_one();
+      }
+    }
+  }
+
+  void WorkerLoop(unsigned int self)
+  {
+    uint64_t seen_generation = 0;
+
+    while (true)
+    {
+      {
+        std::unique_lock lock(state_mutex);
+        wake_cv.wait(lock, [&] { return stopping || generation != seen_generation; });
+
+        if (stopping)
+          return;
+
+        seen_generation = generation;
+      }
+
+      RunTasks(self);
+    }
+  }
+
+private:
+  unsigned int thread_count;
+  std::unique_ptr<Queue[]> queues;
+  std::vector<std::thread> workers;
+
+  std::mutex run_mutex;
+  std::function<void(size_t)> job;
+  std::atomic<size_t> pending = 0;
+
+  std::mutex state_mutex;
+  std::condition_variable wake_cv;
+  std::condition_variable done_cv;
+  uint64_t generation = 0;
+  bool stopping = false;
+};
+
+// First-match search split into chunks across the pool. The lowest match offset found so far is shared through
+// an atomic, so chunks and sub-chunks above it are skipped instead of scanned.
+const void* ImMemchrParallel(const void* buf, int val, size_t count, ImThreadPool& pool, ImMemchrFunc kernel = ImMemchr)
+{
+  if (count < IMGUI_PARALLEL_MIN_LENGTH || pool.GetThreadCount() <= 1)
+    return kernel(buf, val, count);
+
+  const unsigned char* begin = (const unsigned char*)buf;
+  const size_t chunk_count = (count + IMGUI_PARALLEL_CHUNK_LENGTH - 1) / IMGUI_PARALLEL_CHUNK_LENGTH;
+  std::atomic<size_t> best = SIZE_MAX;
+
+  pool.ParallelFor(chunk_count, [&](size_t chunk)
+  {
+    const size_t chunk_start = chunk * IMGUI_PARALLEL_CHUNK_LENGTH;
+    const size_t chunk_end = std::min(count, chunk_start + IMGUI_PARALLEL_CHUNK_LENGTH);
+
+    for (size_t pos = chunk_start; pos < chunk_end; pos += IMGUI_PARALLEL_CANCEL_LENGTH)
+    {
+      if (best.load(std::memory_order_relaxed) < pos)
+        return;
+
+      const size_t length = std::min<size_t>(IMGUI_PARALLEL_CANCEL_LENGTH, chunk_end - pos);
+      const unsigned char* match = (const unsigned char*)kernel(begin + pos, val, length);
+
+      if (match)
+      {
+        size_t offset = match - begin;
+        size_t current = best.load(std::memory_order_relaxed);
+
+        while (offset < current && !best.compare_exchange_weak(current, offset, std::memory_order_relaxed))
+          ;
+
+        return;
+      }
+    }
+  });
+
+  const size_t offset = best.load(std::memory_order_relaxed);
+  return offset == SIZE_MAX ? nullptr : (const void*)(begin + offset);
+}
+
+// Occurrence count split into chunks across the pool, every chunk adds its count to a shared total
+size_t ImMemcountParallel(const void* buf, int val, size_t count, ImThreadPool& pool, ImMemcountFunc kernel = ImMemcount)
+{
+  if (count < IMGUI_PARALLEL_MIN_LENGTH || pool.GetThreadCount() <= 1)
+    return kernel(buf, val, count);
+
+  const unsigned char* begin = (const unsigned char*)buf;
+  const size_t chunk_count = (count + IMGUI_PARALLEL_CHUNK_LENGTH - 1) / IMGUI_PARALLEL_CHUNK_LENGTH;
+  std::atomic<size_t> total = 0;
+
+  pool.ParallelFor(chunk_count, [&](size_t chunk)
+  {
+    const size_t chunk_start = chunk * IMGUI_PARALLEL_CHUNK_LENGTH;
+    const size_t chunk_end = std::min(count, chunk_start + IMGUI_PARALLEL_CHUNK_LENGTH);
+
+    total.fetch_add(kernel(begin + chunk_start, val, chunk_end - chunk_start), std::memory_order_relaxed);
+  });
+
+  return total.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware events by their perf names. Every event is counted in user space only, which is allowed up to
+// perf_event_paranoid 2.
+static const char* const ImPerfEventNames[] =
+{
+  "cycles",
+  "instructions",
+  "branches",
+  "branch-misses",
+  "cache-misses",
+  "stalled-cycles-frontend",
+  "stalled-cycles-backend",
+  "L1-dcache-load-misses",
+  "LLC-load-misses",
+  "dTLB-load-misses",
+};
+
+// Hardware counters of the calling thread, in as few groups as the PMU can schedule. A group is enabled and read
+// together so the ratios within it hold. A group asking for more counters than the PMU has is never scheduled and
+// reads zero without an error, so Open test-enables every group as it grows and starts a new group with the event
+// that did not fit. Unknown or unsupported events are left out. Without perf_event_open (other systems, containers
+// with a high perf_event_paranoid, no PMU in the VM) Open fails and nothing is counted. Counts are scaled when the
+// kernel had to multiplex a group, which it does whenever there are several.
+class ImPerfCounters
+{
+public:
+  ImPerfCounters() = default;
+
+  ~ImPerfCounters()
+  {
+    Close();
+  }
+
+  ImPerfCounters(const ImPerfCounters&) = delete;
+  ImPerfCounters& operator=(const ImPerfCounters&) = delete;
+
+  bool Open(const std::vector<std::string>& event_names)
+  {
+    Close();
+
+#if defined(__linux__)
+    for (const std::string& name : event_names)
+    {
+      perf_event_attr attr;
+      if (!GetEventAttr(name, attr))
+        continue;
+
+      // Added to the last group, or leading a new one when it does not fit there
+      if (!groups.empty() && AddEvent(attr, name, groups.back()))
+        continue;
+
+      const size_t group_start = fds.size();
+
+      if (AddEvent(attr, name, group_start))
+        groups.push_back(group_start);
+    }
+
+    values.assign(fds.size(), 0);
+    counted.assign(fds.size(), false);
+#else
+    (void)event_names;
+#endif
+
+    return IsOpen();
+  }
+
+  void Close()
+  {
+#if defined(__linux__)
+    // Members first, the leaders last
+    for (size_t i = fds.size(); i-- > 0; )
+      close(fds[i]);
+#endif
+
+    fds.clear();
+    names.clear();
+    values.clear();
+    counted.clear();
+    groups.clear();
+  }
+
+  bool IsOpen() const
+  {
+    return !fds.empty();
+  }
+
+  void Start()
+  {
+#if defined(__linux__)
+    if (!IsOpen())
+      return;
+
+    for (size_t group_start : groups)
+    {
+      ioctl(fds[group_start], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(fds[group_start], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+  }
+
+  // Returns false when no group was scheduled on the PMU. The events of a group that was not have no value.
+  bool Stop()
+  {
+#if defined(__linux__)
+    if (!IsOpen())
+      return false;
+
+    for (size_t group_start : groups)
+      ioctl(fds[group_start], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    values.assign(fds.size(), 0);
+    counted.assign(fds.size(), false);
+
+    bool any_counted = false;
+
+    for (size_t group = 0; group < groups.size(); group++)
+    {
+      const size_t group_start = groups[group];
+      const size_t group_end = group + 1 < groups.size() ? groups[group + 1] : fds.size();
+
+      uint64_t time_enabled = 0;
+      uint64_t time_running = 0;
+
+      if (!ReadGroup(group_start, group_end - group_start, time_enabled, time_running, values.data() + group_start) || time_running == 0)
+        continue;
+
+      const double scale = double(time_enabled) / double(time_running);
+
+      for (size_t i = group_start; i < group_end; i++)
+      {
+        values[i] = uint64_t(double(values[i]) * scale);
+        counted[i] = true;
+      }
+
+      any_counted = true;
+    }
+
+    return any_counted;
+#else
+    return false;
+#endif
+  }
+
+  // Number of perf_event groups the events were split into, 1 when the PMU counts them all together
+  size_t GetGroupCount() const
+  {
+    return groups.size();
+  }
+
+  size_t GetCount() const
+  {
+    return names.size();
+  }
+
+  const std::string& GetName(size_t i) const
+  {
+    return names[i];
+  }
+
+  uint64_t GetValue(size_t i) const
+  {
+    return values[i];
+  }
+
+  // False when the group of the event was not scheduled between Start and Stop
+  bool HasValue(size_t i) const
+  {
+    return counted[i];
+  }
+
+  // Value of a counted event, 0 when it is not part of the group
+  uint64_t GetValue(std::string_view name) const
+  {
+    for (size_t i = 0; i < names.size(); i++)
+    {
+      if (names[i] == name)
+        return values[i];
+    }
+
+    return 0;
+  }
+
+private:
+#if defined(__linux__)
+  // Opens the event into the group starting at group_start, fds.size() for a new group, and keeps it when the
+  // grown group still runs on the PMU
+  bool AddEvent(perf_event_attr attr, const std::string& name, size_t group_start)
+  {
+    const bool leader = group_start == fds.size();
+
+    attr.disabled = leader ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader ? -1 : fds[group_start], 0);
+    if (fd < 0)
+      return false;
+
+    fds.push_back(fd);
+    names.push_back(name);
+
+    if (TestGroup(group_start))
+      return true;
+
+    close(fd);
+    fds.pop_back();
+    names.pop_back();
+    return false;
+  }
+
+  // Enables the group over a short loop and checks that it ran at all
+  bool TestGroup(size_t group_start)
+  {
+    const int leader = fds[group_start];
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    volatile uint64_t sink = 0;
+    for (uint64_t i = 0; i < 100000; i++)
+      sink = sink + i;
+
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    uint64_t time_enabled = 0;
+    uint64_t time_running = 0;
+    std::vector<uint64_t> group_values(fds.size() - group_start);
+
+    return ReadGroup(group_start, group_values.size(), time_enabled, time_running, group_values.data()) && time_running != 0;
+  }
+
+  // nr, time_enabled, time_running, then one value per event in opening order
+  bool ReadGroup(size_t group_start, size_t event_count, uint64_t& time_enabled, uint64_t& time_running, uint64_t* group_values) const
+  {
+    std::vector<uint64_t> group(3 + event_count);
+    const ssize_t read_size = read(fds[group_start], group.data(), group.size() * sizeof(uint64_t));
+
+    if (read_size != ssize_t(group.size() * sizeof(uint64_t)))
+      return false;
+
+    time_enabled = group[1];
+    time_running = group[2];
+    std::memcpy(group_values, group.data() + 3, event_count * sizeof(uint64_t));
+    return true;
+  }
+
+  static bool GetEventAttr(std::string_view name, perf_event_attr& attr)
+  {
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+
+    const uint64_t read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    if (name == "cycles")
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    else if (name == "instructions")
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    else if (name == "branches")
+      attr.config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+    else if (name == "branch-misses")
+      attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+    else if (name == "cache-misses")
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    else if (name == "stalled-cycles-frontend")
+      attr.config = PERF_COUNT_HW_STALLED_CYCLES_FRONTEND;
+    else if (name == "stalled-cycles-backend")
+      attr.config = PERF_COUNT_HW_STALLED_CYCLES_BACKEND;
+    else
+    {
+      attr.type = PERF_TYPE_HW_CACHE;
+
+      if (name == "L1-dcache-load-misses")
+        attr.config = PERF_COUNT_HW_CACHE_L1D | read_miss;
+      else if (name == "LLC-load-misses")
+        attr.config = PERF_COUNT_HW_CACHE_LL | read_miss;
+      else if (name == "dTLB-load-misses")
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | read_miss;
+      else
+        return false;
+    }
+
+    return true;
+  }
+#endif
+
+private:
+  std::vector<int> fds;
+  std::vector<std::string> names;
+  std::vector<uint64_t> values;
+  std::vector<bool> counted;
+
+  // Index in fds of the leader of each group, the group runs up to the next leader
+  std::vector<size_t> groups;
+};